@@ -2,8 +2,25 @@
 //
 // NOTES:
 //  - use #define BB_PLATFORM_IMPLEMENTATION before including this file to include implementation
+//  - use #define BB_PLATFORM_NO_MAIN if you want to write your own main (e.g. dedicated server), call
+//    bb_NextFrame once per iteration of your loop then
+//  - use #define BB_PLATFORM_FRAME_ARENA_SIZE to change size of per thread frame arena (default 64MB of
+//    reserved address space, committed as it grows)
+//  - use #define BB_PLATFORM_MAX_EMPTY_SPANS to change how many empty 64KB spans every size class of
+//    bb_AllocateMemory keeps for reuse before giving them back to the OS (default 4)
+//  - use #define BB_PLATFORM_EVENT_QUEUE_SIZE to change capacity of the events queue (power of two,
+//    default 1024)
+//  - use #define BB_PLATFORM_TARGET_FRAME_RATE to limit frame rate of the main loop (default 0 - no
+//    limit), can be changed at runtime in FramePacing of bb_platform_state
+//  - use #define BB_PLATFORM_PROFILE to record BB_PROFILE_SCOPE zones (main loop phases and thread
+//    pool tasks have them already), without it zones compile to nothing
+//  - use #define BB_PLATFORM_PROFILE_RING_SIZE to change how many zones every thread keeps (power of
+//    two, default 65536)
 //  - Win32:
-//     - libs required: opengl32.lib (if using opengl)
+//     - libs required: opengl32.lib (if using opengl), synchronization.lib (WaitOnAddress, windows 8+)
+//  - Linux:
+//     - headless, no window and no opengl context yet
+//     - libs required: pthread
 //  You can define these functions to work with them in your game
 //    BB_PLATFORM_INIT - calls after creating window and opengl context
 //    BB_PLATFORM_LOOP
@@ -11,10 +28,14 @@
 //    BB_PLATFORM_SHUTDOWN - calls just before exiting an app
 //    BB_PLATFORM_PROCESSEVENT - it takes 1 argument which is pointer to bb_event structure, and it's called in
 //                               event pulling loop
+//    BB_PLATFORM_FIXED_UPDATE - takes fixed delta time, called 0..MaxSteps times per frame before
+//                               BB_PLATFORM_LOOP so simulation runs at FixedUpdate.TickRate whatever
+//                               the frame rate is (default 60, BB_PLATFORM_FIXED_UPDATE_RATE)
+//    BB_PLATFORM_RENDER - takes interpolation alpha between last two fixed updates, called after
+//                         BB_PLATFORM_LOOP
 // TODO:
-//  - threads
-//    - thread pool too
 //  - mouse wheel
+//  - linux window (x11)
 // KNOWN BUGS:
 //  - sometimes when you press some keys while moving mouse, it doesnt update key state to down
 
@@ -22,47 +43,1728 @@
 
 #if defined(_WIN32)
 #define BB_PLATFORM_WIN32
+#elif defined(__linux__)
+#define BB_PLATFORM_LINUX
+#endif
+
+#include "bb_tool.h"
+
+#ifndef BB_TOOL_H_
+#error "Include bb_tool library!"
+#endif
+
+#define __bb_CacheLineSize 64
+
+#ifndef BB_PLATFORM_EVENT_QUEUE_SIZE
+#define BB_PLATFORM_EVENT_QUEUE_SIZE 1024
+#endif
+
+#ifndef BB_PLATFORM_FIXED_UPDATE_RATE
+#define BB_PLATFORM_FIXED_UPDATE_RATE 60
+#endif
+
+#ifndef BB_PLATFORM_FIXED_UPDATE_MAX_STEPS
+#define BB_PLATFORM_FIXED_UPDATE_MAX_STEPS 8
+#endif
+
+#ifndef BB_PLATFORM_TARGET_FRAME_RATE
+#define BB_PLATFORM_TARGET_FRAME_RATE 0
+#endif
+
+#ifndef BB_PLATFORM_PROFILE_RING_SIZE
+#define BB_PLATFORM_PROFILE_RING_SIZE 65536
 #endif
 
 #ifdef BB_PLATFORM_WIN32
 #include "bb_platform_win32.h"
 #endif
 
-#include "bb_tool.h"
+#ifdef BB_PLATFORM_LINUX
+#include "bb_platform_linux.h"
+#endif
+
+// events
+// NOTE(Brajan): events go through a lock-free single producer/single consumer ring, the thread that
+// calls bb_UpdateWindow is the producer and the thread that pulls events is the consumer (they can
+// be different threads). bb_PullEvents copies up to MaxEvents events and returns how many it got.
+// Events that don't fit are dropped and counted, see bb_GetDroppedEventCount.
+bool bb_PullEvent(bb_event *Event);
+int bb_PullEvents(bb_event *Events, int MaxEvents);
+long long bb_GetDroppedEventCount();
+
+// NOTE(Brajan): mutexes are built on bb_WaitOnAddress/bb_WakeAddress* of the backend. Lock spins
+// a bit (adaptive) and then parks, uncontended lock and unlock are one atomic each.
+struct bb_mutex {
+  // NOTE(Brajan): 0 - unlocked, 1 - locked, 2 - locked with waiters
+  volatile int State;
+  volatile int SpinCount;
+};
+
+struct bb_rw_mutex {
+  // NOTE(Brajan): readers count, writer bit and waiters bit
+  volatile int State;
+};
+
+// mutex
+int bb_CreateMutex(bb_mutex *Mutex);
+void bb_DestroyMutex(bb_mutex *Mutex);
+void bb_Lock(bb_mutex *Mutex);
+void bb_Unlock(bb_mutex *Mutex);
+bool bb_TryLock(bb_mutex *Mutex);
+
+// reader-writer mutex
+int bb_CreateRWMutex(bb_rw_mutex *Mutex);
+void bb_DestroyRWMutex(bb_rw_mutex *Mutex);
+void bb_LockRead(bb_rw_mutex *Mutex);
+void bb_UnlockRead(bb_rw_mutex *Mutex);
+void bb_LockWrite(bb_rw_mutex *Mutex);
+void bb_UnlockWrite(bb_rw_mutex *Mutex);
+
+// NOTE(Brajan): every worker owns a chase-lev deque, tasks pushed from a worker go to its own deque,
+// tasks pushed from other threads go to the shared Tasks queue (bounded lock-free fifo). Idle workers
+// steal from random victims and park on Signal when there is nothing to do.
+struct bb_thread_pool {
+  bb_thread *Workers;
+  int NumWorkers;
+
+  // NOTE(Brajan): do not set these variables manually
+  void *Deques;
+
+  void *Tasks;
+  long long TasksMask;
+  char TasksPadding[__bb_CacheLineSize];
+  volatile long long TasksEnqueuePosition;
+  char EnqueuePadding[__bb_CacheLineSize - sizeof(long long)];
+  volatile long long TasksDequeuePosition;
+  char DequeuePadding[__bb_CacheLineSize - sizeof(long long)];
+
+  volatile int Signal;
+  volatile int NumSleeping;
+  volatile int StopFlag;
+};
+
+// thread pool
+// NOTE(Brajan): bb_CreateThreadPool returns 0 on success, non zero when NumWorkers or MaxTasks is not
+// positive, MaxTasks is too big, or memory or threads can't be had (nothing is left allocated then).
+// After bb_StopThreadPool workers still run every queued task and exit once all queues are empty,
+// so task groups waiting on them finish. Don't push tasks from other threads after stopping.
+// bb_DestroyThreadPool stops the pool and joins workers.
+int bb_CreateThreadPool(bb_thread_pool *ThreadPool, int NumWorkers, int MaxTasks);
+void bb_DestroyThreadPool(bb_thread_pool *ThreadPool);
+void bb_StopThreadPool(bb_thread_pool *ThreadPool);
+int bb_PushTaskToThreadPool(bb_thread_pool *ThreadPool, void(*Function)(void *), void *Data);
+
+// NOTE(Brajan): task group counts tasks that are not finished yet, waiting thread executes other
+// queued tasks until the group is done. Tasks of the group can push more tasks to it, parked
+// waiters are woken to help with them. Zero initialized group is valid.
+struct bb_task_group {
+  volatile int NumPending;
+  volatile int NumWaiting;
+};
+
+void bb_InitTaskGroup(bb_task_group *Group);
+int bb_PushTaskToGroup(bb_thread_pool *ThreadPool, bb_task_group *Group, void(*Function)(void *), void *Data);
+void bb_WaitTaskGroup(bb_thread_pool *ThreadPool, bb_task_group *Group);
+
+// splits [Begin, End) into Grain sized chunks and runs Function on them across workers and calling
+// thread, returns when all chunks are done
+void bb_ParallelFor(bb_thread_pool *ThreadPool, int Begin, int End, int Grain,
+                    void (*Function)(int Begin, int End, void *Data), void *Data);
+
+// virtual arena
+// NOTE(Brajan): reserves ReserveSize of address space and commits it in CommitGranularity steps as
+// arena grows (0 means 64KB, or large page size with bb_MemoryLargePages)
+void bb_CreateVirtualArena(bb_memory_arena *Arena, size_t ReserveSize, int Flags, size_t CommitGranularity = 0);
+void bb_DestroyVirtualArena(bb_memory_arena *Arena);
+
+// frame memory
+// NOTE(Brajan): every thread gets its own frame arena on first use. Arena is reset the first time it
+// is used after bb_NextFrame, so memory pushed there lives until the end of the current frame.
+// Address space of the arena is released when its thread exits.
+bb_memory_arena *bb_GetFrameArena();
+void bb_NextFrame();
+
+// cycle counter
+// NOTE(Brajan): rdtsc (cntvct_el0 on arm64) for timing short pieces of code, much cheaper than
+// bb_GetPerformanceCounter. Cycles are converted to time with bb_GetCycleFrequency which measures
+// counter against performance counter on first call (takes ~10ms), assumes invariant tsc.
+inline unsigned long long
+bb_ReadCycleCounter() {
+#if defined(BB_TOOL_X86)
+  return __rdtsc();
+#elif defined(__aarch64__) && !defined(_MSC_VER)
+  unsigned long long Cycles;
+  __asm__ volatile("mrs %0, cntvct_el0" : "=r"(Cycles));
+  return Cycles;
+#else
+  return (unsigned long long)bb_GetPerformanceCounter();
+#endif
+}
+
+double bb_GetCycleFrequency();
+double bb_CyclesToSeconds(unsigned long long Cycles);
+
+// profiler
+// NOTE(Brajan): BB_PROFILE_SCOPE("name") records a zone from the macro to the end of the scope.
+// Every thread writes finished zones to its own ring, no locks and no atomics other than
+// publishing the write position, when the ring is full the oldest zones are overwritten. Name
+// has to live as long as the program (string literal). Rings are kept after their thread exits.
+struct bb_profile_zone {
+  const char *Name;
+  unsigned long long Begin;
+  unsigned long long End;
+};
+
+#ifdef BB_PLATFORM_PROFILE
+void bb_ProfilerSetThreadName(const char *Name);
+
+// NOTE(Brajan): writes zones recorded so far to Path as chrome trace json (chrome://tracing or
+// ui.perfetto.dev). It only takes ring positions and returns, the file is created and written by a
+// background thread, bb_ProfilerWaitTrace waits for it and returns false if that failed. Returns
+// false when previous dump is still running. Call both from one thread.
+bool bb_ProfilerDumpTrace(const char *Path);
+bool bb_ProfilerWaitTrace();
+
+void __bb_ProfilerRecordZone(const char *Name, unsigned long long Begin, unsigned long long End);
+
+struct __bb_profile_scope {
+  const char *Name;
+  unsigned long long Begin;
+
+  __bb_profile_scope(const char *Name) : Name(Name), Begin(bb_ReadCycleCounter()) {}
+  ~__bb_profile_scope() { __bb_ProfilerRecordZone(Name, Begin, bb_ReadCycleCounter()); }
+};
+
+#define __bb_ProfileConcat2(A, B) A##B
+#define __bb_ProfileConcat(A, B) __bb_ProfileConcat2(A, B)
+#define BB_PROFILE_SCOPE(Name) __bb_profile_scope __bb_ProfileConcat(__bb_ProfileScope, __LINE__)(Name)
+#else
+#define bb_ProfilerSetThreadName(Name)
+#define bb_ProfilerDumpTrace(Path) false
+#define bb_ProfilerWaitTrace() false
+#define BB_PROFILE_SCOPE(Name)
+#endif
+
+#define bb_NumKeys 256
+#define bb_NumButtons 128
+
+struct bb_platform_state {
+  bb_window Window;
+
+  struct {
+    bool Keys[bb_NumKeys];
+    bool KeysDown[bb_NumKeys];
+    bool KeysUp[bb_NumKeys];
+
+    bool Buttons[bb_NumButtons];
+    bool ButtonsDown[bb_NumButtons];
+    bool ButtonsUp[bb_NumButtons];
+
+    int MouseX;
+    int MouseY;
+
+    int MouseMoveX;
+    int MouseMoveY;
+  } InputState;
+
+  // NOTE(Brajan): counts for the last frame, NumMouseMoves is before merging runs of mouse moves
+  // into one event, NumDropped is total since start (queue was full)
+  struct {
+    int NumEvents;
+    int NumMouseMoves;
+    long long NumDropped;
+  } EventStats;
+
+  // NOTE(Brajan): used with BB_PLATFORM_FIXED_UPDATE, TickRate and MaxSteps can be changed in
+  // BB_PLATFORM_INIT. When a frame needs more than MaxSteps updates the rest of the time is thrown
+  // away (NumSkippedSteps) instead of falling further behind. Alpha is how far the frame is between
+  // the last fixed update and the next one (0..1).
+  struct {
+    float TickRate;
+    int MaxSteps;
+    int NumSteps;
+    long long NumSkippedSteps;
+    float Alpha;
+  } FixedUpdate;
+
+  // NOTE(Brajan): TargetFrameRate 0 means no limit. LateInputSampling waits before polling input
+  // instead of after present, so the frame is finished just in time for the next one and input is
+  // as fresh as possible. It needs TargetFrameRate, with vsync set it to the refresh rate.
+  struct {
+    float TargetFrameRate;
+    bool LateInputSampling;
+  } FramePacing;
+
+  // NOTE(Brajan): in seconds, Min/Average/P99 are over the last 128 frames. WorkTime is time from
+  // polling input to present (without waiting in present).
+  struct {
+    float FrameTime;
+    float WorkTime;
+    float MinFrameTime;
+    float AverageFrameTime;
+    float P99FrameTime;
+  } FrameStats;
+};
+
+// ----------------------------------------------------------------------------
+// -----------------------------IMPLEMENTATION---------------------------------
+// ----------------------------------------------------------------------------
+#ifdef BB_PLATFORM_IMPLEMENTATION
+
+// mutex
+#define __bb_MutexMaxSpin 200
+
+int
+bb_CreateMutex(bb_mutex *Mutex) {
+  Mutex->State = 0;
+  Mutex->SpinCount = 0;
+  return 0;
+}
+
+void
+bb_DestroyMutex(bb_mutex *Mutex) {
+  (void)Mutex;
+}
+
+void
+bb_Lock(bb_mutex *Mutex) {
+  int State = bb_AtomicCompareExchange(&Mutex->State, 0, 1);
+  if (State == 0)
+    return;
+
+  // NOTE(Brajan): spin a bit before going to sleep, spin limit adapts to how long it took to get
+  // the lock last times. SpinCount is a hint, racing updates may lose each other.
+  int SpinCount = bb_AtomicLoad(&Mutex->SpinCount);
+  int MaxSpin = SpinCount * 2 + 10;
+  if (MaxSpin > __bb_MutexMaxSpin)
+    MaxSpin = __bb_MutexMaxSpin;
+
+  int Spin = 0;
+  for (; Spin < MaxSpin; ++Spin) {
+    bb_YieldProcessor();
+    State = bb_AtomicLoad(&Mutex->State);
+    if (State == 0) {
+      State = bb_AtomicCompareExchange(&Mutex->State, 0, 1);
+      if (State == 0) {
+        bb_AtomicStore(&Mutex->SpinCount, SpinCount + (Spin - SpinCount) / 8);
+        return;
+      }
+    }
+  }
+
+  // NOTE(Brajan): mark lock as contended before sleeping, so unlock knows it has to wake someone
+  if (State != 2)
+    State = bb_AtomicExchange(&Mutex->State, 2);
+
+  while (State != 0) {
+    bb_WaitOnAddress(&Mutex->State, 2);
+    State = bb_AtomicExchange(&Mutex->State, 2);
+  }
+
+  bb_AtomicStore(&Mutex->SpinCount, SpinCount + (Spin - SpinCount) / 8);
+}
+
+void
+bb_Unlock(bb_mutex *Mutex) {
+  if (bb_AtomicAdd(&Mutex->State, -1) != 1) {
+    bb_AtomicStore(&Mutex->State, 0);
+    bb_WakeAddressSingle(&Mutex->State);
+  }
+}
+
+bool
+bb_TryLock(bb_mutex *Mutex) {
+  return bb_AtomicCompareExchange(&Mutex->State, 0, 1) == 0;
+}
+
+// reader-writer mutex
+#define __bb_RWMutexWriter  (1 << 30)
+#define __bb_RWMutexWaiters (1 << 29)
+#define __bb_RWMutexReaders (__bb_RWMutexWaiters - 1)
+
+int
+bb_CreateRWMutex(bb_rw_mutex *Mutex) {
+  Mutex->State = 0;
+  return 0;
+}
+
+void
+bb_DestroyRWMutex(bb_rw_mutex *Mutex) {
+  (void)Mutex;
+}
+
+// NOTE(Brajan): sets waiters bit (if it is not set already) and sleeps until state changes
+static void
+__bb_WaitRWMutex(bb_rw_mutex *Mutex, int State) {
+  if ((State & __bb_RWMutexWaiters) == 0) {
+    if (bb_AtomicCompareExchange(&Mutex->State, State, State | __bb_RWMutexWaiters) != State)
+      return;
+  }
+  bb_WaitOnAddress(&Mutex->State, State | __bb_RWMutexWaiters);
+}
+
+void
+bb_LockRead(bb_rw_mutex *Mutex) {
+  for (int Spin = 0;; ++Spin) {
+    int State = bb_AtomicLoad(&Mutex->State);
+
+    // NOTE(Brajan): new readers wait when somebody is sleeping, so writers don't starve
+    if ((State & (__bb_RWMutexWriter | __bb_RWMutexWaiters)) == 0) {
+      if (bb_AtomicCompareExchange(&Mutex->State, State, State + 1) == State)
+        return;
+    } else if (Spin < __bb_MutexMaxSpin) {
+      bb_YieldProcessor();
+    } else {
+      __bb_WaitRWMutex(Mutex, State);
+    }
+  }
+}
+
+void
+bb_UnlockRead(bb_rw_mutex *Mutex) {
+  int State = bb_AtomicAdd(&Mutex->State, -1) - 1;
+  if (State == __bb_RWMutexWaiters) {
+    if (bb_AtomicCompareExchange(&Mutex->State, State, 0) == State)
+      bb_WakeAddressAll(&Mutex->State);
+  }
+}
+
+void
+bb_LockWrite(bb_rw_mutex *Mutex) {
+  for (int Spin = 0;; ++Spin) {
+    int State = bb_AtomicLoad(&Mutex->State);
+    if ((State & (__bb_RWMutexWriter | __bb_RWMutexReaders)) == 0) {
+      if (bb_AtomicCompareExchange(&Mutex->State, State, State | __bb_RWMutexWriter) == State)
+        return;
+    } else if (Spin < __bb_MutexMaxSpin) {
+      bb_YieldProcessor();
+    } else {
+      __bb_WaitRWMutex(Mutex, State);
+    }
+  }
+}
+
+void
+bb_UnlockWrite(bb_rw_mutex *Mutex) {
+  if (bb_AtomicExchange(&Mutex->State, 0) & __bb_RWMutexWaiters)
+    bb_WakeAddressAll(&Mutex->State);
+}
+
+// memory
+// NOTE(Brajan): small blocks come from 64KB spans, every span holds blocks of one size class and
+// starts with a header, so free finds the class by masking the pointer. Classes go by 16 bytes up
+// to 128, then 4 classes per power of two up to 16KB. Anything bigger gets its own span straight
+// from the OS. Every span keeps its own free blocks, so the class knows when all of them came back.
+// A class keeps up to BB_PLATFORM_MAX_EMPTY_SPANS such empty spans for reuse and gives the rest back
+// to the OS. Threads don't touch classes directly, see thread caches below.
+#define __bb_MemorySpanSize (64 * 1024)
+#define __bb_MemorySpanHeaderSize 64
+#define __bb_NumSizeClasses 36
+#define __bb_MaxSmallSize 16384
+#define __bb_LargeSizeClass -1
+
+#ifndef BB_PLATFORM_MAX_EMPTY_SPANS
+#define BB_PLATFORM_MAX_EMPTY_SPANS 4
+#endif
+
+struct __bb_free_block {
+  __bb_free_block *Next;
+};
+
+// NOTE(Brajan): everything after SizeClass is used only by spans of small blocks, with their class
+// locked. Blocks are carved from the Unused tail lazily, NumUsed counts blocks out of the span.
+struct __bb_memory_span {
+  size_t Size;
+  int SizeClass;
+
+  int NumUsed;
+  __bb_free_block *FreeList;
+  char *Unused;
+  __bb_memory_span *Previous;
+  __bb_memory_span *Next;
+};
+
+static_assert(sizeof(__bb_memory_span) <= __bb_MemorySpanHeaderSize, "span header doesn't fit");
+
+// NOTE(Brajan): Spans lists the spans that still have a block to give, full ones leave the list
+// until a block comes back
+struct __bb_size_class {
+  bb_mutex Mutex;
+  __bb_memory_span *Spans;
+  int NumSpans;
+  int NumEmptySpans;
+  char Padding[__bb_CacheLineSize - sizeof(bb_mutex) - sizeof(void *) - sizeof(int) * 2];
+};
+
+static __bb_size_class __bb_SizeClasses[__bb_NumSizeClasses];
+
+static int
+__bb_GetSizeClass(size_t Size) {
+  if (Size <= 128)
+    return Size ? (int)((Size - 1) / 16) : 0;
+
+  int Shift = 7;
+  while ((Size - 1) >> (Shift + 1))
+    ++Shift;
+  return 8 + (Shift - 7) * 4 + (int)((Size - 1 - ((size_t)1 << Shift)) >> (Shift - 2));
+}
+
+static size_t
+__bb_GetSizeClassSize(int SizeClass) {
+  if (SizeClass < 8)
+    return (size_t)(SizeClass + 1) * 16;
+
+  int Group = (SizeClass - 8) / 4;
+  int Step = (SizeClass - 8) % 4;
+  return ((size_t)128 << Group) + (size_t)(Step + 1) * ((size_t)32 << Group);
+}
+
+static void
+__bb_LinkSpan(__bb_size_class *SizeClass, __bb_memory_span *Span) {
+  Span->Previous = 0;
+  Span->Next = SizeClass->Spans;
+  if (SizeClass->Spans)
+    SizeClass->Spans->Previous = Span;
+  SizeClass->Spans = Span;
+}
+
+static void
+__bb_UnlinkSpan(__bb_size_class *SizeClass, __bb_memory_span *Span) {
+  if (Span->Previous)
+    Span->Previous->Next = Span->Next;
+  else
+    SizeClass->Spans = Span->Next;
+  if (Span->Next)
+    Span->Next->Previous = Span->Previous;
+}
+
+static bool
+__bb_IsSpanFull(__bb_memory_span *Span, size_t BlockSize) {
+  return Span->FreeList == 0 && Span->Unused + BlockSize > (char *)Span + __bb_MemorySpanSize;
+}
+
+// NOTE(Brajan): takes block from the first span of the class that has one, or from a new span, class
+// has to be locked. 0 when there is no block left and the os has no pages.
+static __bb_free_block *
+__bb_AllocateBlock(__bb_size_class *SizeClass, int SizeClassIndex, size_t BlockSize) {
+  __bb_memory_span *Span = SizeClass->Spans;
+  if (Span == 0) {
+    Span = (__bb_memory_span *)__bb_AllocatePages(__bb_MemorySpanSize);
+    if (Span == 0)
+      return 0;
+
+    Span->Size = __bb_MemorySpanSize;
+    Span->SizeClass = SizeClassIndex;
+    Span->NumUsed = 0;
+    Span->FreeList = 0;
+    Span->Unused = (char *)Span + __bb_MemorySpanHeaderSize;
+    __bb_LinkSpan(SizeClass, Span);
+    ++SizeClass->NumSpans;
+    ++SizeClass->NumEmptySpans;
+  }
+
+  __bb_free_block *Block = Span->FreeList;
+  if (Block) {
+    Span->FreeList = Block->Next;
+  } else {
+    Block = (__bb_free_block *)Span->Unused;
+    Span->Unused += BlockSize;
+  }
+
+  if (Span->NumUsed++ == 0)
+    --SizeClass->NumEmptySpans;
+  if (__bb_IsSpanFull(Span, BlockSize))
+    __bb_UnlinkSpan(SizeClass, Span);
+  return Block;
+}
+
+// NOTE(Brajan): gives block back to its span, class has to be locked. Span that gets empty is kept
+// when the class has less than BB_PLATFORM_MAX_EMPTY_SPANS empty ones, otherwise it goes back to the os.
+static void
+__bb_FreeBlock(__bb_size_class *SizeClass, __bb_free_block *Block, size_t BlockSize) {
+  __bb_memory_span *Span = (__bb_memory_span *)((size_t)Block & ~(size_t)(__bb_MemorySpanSize - 1));
+  if (__bb_IsSpanFull(Span, BlockSize))
+    __bb_LinkSpan(SizeClass, Span);
+  Block->Next = Span->FreeList;
+  Span->FreeList = Block;
+
+  if (--Span->NumUsed == 0) {
+    if (SizeClass->NumEmptySpans < BB_PLATFORM_MAX_EMPTY_SPANS) {
+      ++SizeClass->NumEmptySpans;
+    } else {
+      __bb_UnlinkSpan(SizeClass, Span);
+      --SizeClass->NumSpans;
+      __bb_FreePages(Span, __bb_MemorySpanSize);
+    }
+  }
+}
+
+// thread caches
+// NOTE(Brajan): every thread keeps a few blocks of each class for itself, so common alloc/free
+// doesn't take any lock. Blocks move between thread cache and class in batches of ~32KB, cache
+// is given back to classes when thread exits. Other thread exit destructors can run after that
+// one, so once the cache is destroyed the thread allocates and frees straight from the classes.
+#define __bb_ThreadCacheBatchBytes (32 * 1024)
+#define __bb_ThreadCacheMinBatch 2
+#define __bb_ThreadCacheMaxBatch 64
+
+struct __bb_thread_cache_bin {
+  __bb_free_block *Blocks;
+  int Count;
+};
+
+struct __bb_thread_cache {
+  __bb_thread_cache_bin Bins[__bb_NumSizeClasses];
+
+  ~__bb_thread_cache();
+};
+
+static thread_local __bb_thread_cache __bb_ThreadCache;
+// NOTE(Brajan): not a member, compiler drops stores to members in destructor (object is dead after)
+static thread_local bool __bb_ThreadCacheDestroyed = false;
+
+static int
+__bb_GetBatchSize(int SizeClassIndex) {
+  size_t Batch = __bb_ThreadCacheBatchBytes / __bb_GetSizeClassSize(SizeClassIndex);
+  if (Batch < __bb_ThreadCacheMinBatch)
+    return __bb_ThreadCacheMinBatch;
+  if (Batch > __bb_ThreadCacheMaxBatch)
+    return __bb_ThreadCacheMaxBatch;
+  return (int)Batch;
+}
+
+static void
+__bb_RefillThreadCache(__bb_thread_cache_bin *Bin, int SizeClassIndex) {
+  __bb_size_class *SizeClass = &__bb_SizeClasses[SizeClassIndex];
+  size_t BlockSize = __bb_GetSizeClassSize(SizeClassIndex);
+  int Batch = __bb_GetBatchSize(SizeClassIndex);
+
+  // NOTE(Brajan): out of memory ends the batch early, bin may stay empty
+  int Count = 0;
+  bb_Lock(&SizeClass->Mutex);
+  for (; Count < Batch; ++Count) {
+    __bb_free_block *Block = __bb_AllocateBlock(SizeClass, SizeClassIndex, BlockSize);
+    if (Block == 0)
+      break;
+
+    Block->Next = Bin->Blocks;
+    Bin->Blocks = Block;
+  }
+  bb_Unlock(&SizeClass->Mutex);
+
+  Bin->Count += Count;
+}
+
+static void
+__bb_FlushThreadCache(__bb_thread_cache_bin *Bin, int SizeClassIndex, int Count) {
+  if (Count <= 0)
+    return;
+
+  __bb_size_class *SizeClass = &__bb_SizeClasses[SizeClassIndex];
+  size_t BlockSize = __bb_GetSizeClassSize(SizeClassIndex);
+  bb_Lock(&SizeClass->Mutex);
+  for (int Index = 0; Index < Count; ++Index) {
+    __bb_free_block *Block = Bin->Blocks;
+    Bin->Blocks = Block->Next;
+    __bb_FreeBlock(SizeClass, Block, BlockSize);
+  }
+  bb_Unlock(&SizeClass->Mutex);
+  Bin->Count -= Count;
+}
+
+__bb_thread_cache::~__bb_thread_cache() {
+  for (int Index = 0; Index < __bb_NumSizeClasses; ++Index) {
+    __bb_FlushThreadCache(&Bins[Index], Index, Bins[Index].Count);
+  }
+  __bb_ThreadCacheDestroyed = true;
+}
+
+void *
+bb_AllocateMemory(int Size) {
+  bb_Assert(Size >= 0);
+
+  if (Size > __bb_MaxSmallSize) {
+    size_t SpanSize = ((size_t)Size + __bb_MemorySpanHeaderSize + __bb_MemorySpanSize - 1) & ~(size_t)(__bb_MemorySpanSize - 1);
+    __bb_memory_span *Span = (__bb_memory_span *)__bb_AllocatePages(SpanSize);
+    if (Span == 0)
+      return 0;
+
+    Span->Size = SpanSize;
+    Span->SizeClass = __bb_LargeSizeClass;
+    return (char *)Span + __bb_MemorySpanHeaderSize;
+  }
+
+  int SizeClassIndex = __bb_GetSizeClass((size_t)Size);
+  __bb_free_block *Block;
+  if (__bb_ThreadCacheDestroyed) {
+    __bb_size_class *SizeClass = &__bb_SizeClasses[SizeClassIndex];
+    bb_Lock(&SizeClass->Mutex);
+    Block = __bb_AllocateBlock(SizeClass, SizeClassIndex, __bb_GetSizeClassSize(SizeClassIndex));
+    bb_Unlock(&SizeClass->Mutex);
+    if (Block == 0)
+      return 0;
+  } else {
+    __bb_thread_cache_bin *Bin = &__bb_ThreadCache.Bins[SizeClassIndex];
+    if (Bin->Blocks == 0) {
+      __bb_RefillThreadCache(Bin, SizeClassIndex);
+      if (Bin->Blocks == 0)
+        return 0;
+    }
+
+    Block = Bin->Blocks;
+    Bin->Blocks = Block->Next;
+    --Bin->Count;
+  }
+
+  // NOTE(Brajan): memory from bb_AllocateMemory was always zeroed (VirtualAlloc), keep it that way
+  bb_ZeroMemory(Block, Size);
+  return Block;
+}
+
+void
+bb_FreeMemory(void *Memory) {
+  if (Memory == 0)
+    return;
+
+  __bb_memory_span *Span = (__bb_memory_span *)((size_t)Memory & ~(size_t)(__bb_MemorySpanSize - 1));
+  if (Span->SizeClass == __bb_LargeSizeClass) {
+    __bb_FreePages(Span, Span->Size);
+    return;
+  }
+
+  __bb_free_block *Block = (__bb_free_block *)Memory;
+  if (__bb_ThreadCacheDestroyed) {
+    __bb_size_class *SizeClass = &__bb_SizeClasses[Span->SizeClass];
+    bb_Lock(&SizeClass->Mutex);
+    __bb_FreeBlock(SizeClass, Block, __bb_GetSizeClassSize(Span->SizeClass));
+    bb_Unlock(&SizeClass->Mutex);
+    return;
+  }
+
+  __bb_thread_cache_bin *Bin = &__bb_ThreadCache.Bins[Span->SizeClass];
+  Block->Next = Bin->Blocks;
+  Bin->Blocks = Block;
+  ++Bin->Count;
+
+  int Batch = __bb_GetBatchSize(Span->SizeClass);
+  if (Bin->Count > Batch * 2)
+    __bb_FlushThreadCache(Bin, Span->SizeClass, Batch);
+}
+
+// thread pool
+#define __bb_ThreadPoolSpinCount 64
+
+struct __bb_worker_task {
+  void(*Function)(void *);
+  void *Data;
+  bb_task_group *Group;
+};
+
+// NOTE(Brajan): Top is touched by thieves, Bottom only by the owner, keep them on separate cache lines
+struct __bb_task_deque {
+  volatile long long Top;
+  char TopPadding[__bb_CacheLineSize - sizeof(long long)];
+
+  volatile long long Bottom;
+  __bb_worker_task *Tasks;
+  long long Mask;
+
+  bb_thread_pool *ThreadPool;
+  unsigned int Random;
+  char BottomPadding[__bb_CacheLineSize - sizeof(long long) * 2 - sizeof(void *) * 2 - sizeof(unsigned int)];
+};
+
+// NOTE(Brajan): Sequence says whose turn it is - equal to position when cell is free for producer,
+// position + 1 when it holds a task for consumer
+struct __bb_task_queue_cell {
+  volatile long long Sequence;
+  __bb_worker_task Task;
+};
+
+static thread_local __bb_task_deque *__bb_CurrentWorker = 0;
+
+// chase-lev deque, push and pop are called only by the owner, steal by anyone
+static bool
+__bb_PushTaskToDeque(__bb_task_deque *Deque, __bb_worker_task Task) {
+  long long Bottom = Deque->Bottom;
+  long long Top = bb_AtomicLoad64(&Deque->Top);
+  if (Bottom - Top > Deque->Mask)
+    return false;
+
+  Deque->Tasks[Bottom & Deque->Mask] = Task;
+  bb_AtomicStore64(&Deque->Bottom, Bottom + 1);
+  return true;
+}
+
+static bool
+__bb_PopTaskFromDeque(__bb_task_deque *Deque, __bb_worker_task *Task) {
+  long long Bottom = Deque->Bottom - 1;
+  bb_AtomicStore64(&Deque->Bottom, Bottom);
+  bb_MemoryBarrier();
+  long long Top = bb_AtomicLoad64(&Deque->Top);
+
+  if (Top > Bottom) {
+    bb_AtomicStore64(&Deque->Bottom, Bottom + 1);
+    return false;
+  }
+
+  *Task = Deque->Tasks[Bottom & Deque->Mask];
+  if (Top == Bottom) {
+    // NOTE(Brajan): last task in deque, thieves may be racing us for it
+    bool Won = (bb_AtomicCompareExchange64(&Deque->Top, Top, Top + 1) == Top);
+    bb_AtomicStore64(&Deque->Bottom, Bottom + 1);
+    return Won;
+  }
+  return true;
+}
+
+// returns 1 on success, 0 when deque is empty and -1 when other thread was faster
+static int
+__bb_StealTaskFromDeque(__bb_task_deque *Deque, __bb_worker_task *Task) {
+  long long Top = bb_AtomicLoad64(&Deque->Top);
+  bb_MemoryBarrier();
+  long long Bottom = bb_AtomicLoad64(&Deque->Bottom);
+
+  if (Top >= Bottom)
+    return 0;
+
+  *Task = Deque->Tasks[Top & Deque->Mask];
+  if (bb_AtomicCompareExchange64(&Deque->Top, Top, Top + 1) != Top)
+    return -1;
+  return 1;
+}
+
+// bounded mpmc queue (dmitry vyukov), fifo and no locks
+static bool
+__bb_PushTaskToQueue(bb_thread_pool *ThreadPool, __bb_worker_task Task) {
+  __bb_task_queue_cell *Cells = (__bb_task_queue_cell *)ThreadPool->Tasks;
+  __bb_task_queue_cell *Cell;
+  long long Position = bb_AtomicLoad64(&ThreadPool->TasksEnqueuePosition);
+  for (;;) {
+    Cell = &Cells[Position & ThreadPool->TasksMask];
+    long long Difference = bb_AtomicLoad64(&Cell->Sequence) - Position;
+    if (Difference == 0) {
+      long long Previous = bb_AtomicCompareExchange64(&ThreadPool->TasksEnqueuePosition, Position, Position + 1);
+      if (Previous == Position)
+        break;
+      Position = Previous;
+    } else if (Difference < 0) {
+      // full
+      return false;
+    } else {
+      Position = bb_AtomicLoad64(&ThreadPool->TasksEnqueuePosition);
+    }
+  }
+
+  Cell->Task = Task;
+  bb_AtomicStore64(&Cell->Sequence, Position + 1);
+  return true;
+}
+
+static bool
+__bb_GetNextTask(bb_thread_pool *ThreadPool, __bb_worker_task *Task) {
+  __bb_task_queue_cell *Cells = (__bb_task_queue_cell *)ThreadPool->Tasks;
+  __bb_task_queue_cell *Cell;
+  long long Position = bb_AtomicLoad64(&ThreadPool->TasksDequeuePosition);
+  for (;;) {
+    Cell = &Cells[Position & ThreadPool->TasksMask];
+    long long Difference = bb_AtomicLoad64(&Cell->Sequence) - (Position + 1);
+    if (Difference == 0) {
+      long long Previous = bb_AtomicCompareExchange64(&ThreadPool->TasksDequeuePosition, Position, Position + 1);
+      if (Previous == Position)
+        break;
+      Position = Previous;
+    } else if (Difference < 0) {
+      // empty
+      return false;
+    } else {
+      Position = bb_AtomicLoad64(&ThreadPool->TasksDequeuePosition);
+    }
+  }
+
+  *Task = Cell->Task;
+  bb_AtomicStore64(&Cell->Sequence, Position + ThreadPool->TasksMask + 1);
+  return true;
+}
+
+// NOTE(Brajan): Worker is null when called from a thread outside of the pool
+static bool
+__bb_FindTask(bb_thread_pool *ThreadPool, __bb_task_deque *Worker, __bb_worker_task *Task) {
+  if (Worker && __bb_PopTaskFromDeque(Worker, Task))
+    return true;
+
+  if (__bb_GetNextTask(ThreadPool, Task))
+    return true;
+
+  __bb_task_deque *Deques = (__bb_task_deque *)ThreadPool->Deques;
+  int NumWorkers = ThreadPool->NumWorkers;
+  int Victim = 0;
+
+  if (Worker) {
+    // xorshift, pick random victim to start stealing from
+    Worker->Random ^= Worker->Random << 13;
+    Worker->Random ^= Worker->Random >> 17;
+    Worker->Random ^= Worker->Random << 5;
+    Victim = (int)(Worker->Random % (unsigned int)NumWorkers);
+  }
+
+  bool Retry = true;
+  while (Retry) {
+    Retry = false;
+    for (int Index = 0; Index < NumWorkers; ++Index) {
+      __bb_task_deque *Deque = &Deques[(Victim + Index) % NumWorkers];
+      if (Deque == Worker)
+        continue;
+
+      int Result = __bb_StealTaskFromDeque(Deque, Task);
+      if (Result == 1)
+        return true;
+      if (Result == -1)
+        Retry = true;
+    }
+  }
+
+  return false;
+}
+
+static void
+__bb_WakeWorker(bb_thread_pool *ThreadPool) {
+  // NOTE(Brajan): pairs with NumSleeping increment in worker, either worker sees our task on
+  // its last check or we see it sleeping
+  bb_MemoryBarrier();
+  if (bb_AtomicLoad(&ThreadPool->NumSleeping) > 0) {
+    bb_AtomicAdd(&ThreadPool->Signal, 1);
+    bb_WakeAddressSingle(&ThreadPool->Signal);
+  }
+}
+
+static void
+__bb_RunTask(__bb_worker_task *Task) {
+  {
+    BB_PROFILE_SCOPE("task");
+    Task->Function(Task->Data);
+  }
+
+  if (Task->Group) {
+    if (bb_AtomicAdd(&Task->Group->NumPending, -1) == 1)
+      bb_WakeAddressAll(&Task->Group->NumPending);
+  }
+}
+
+static void
+__bb_ThreadPoolWorker(void *Data) {
+  __bb_task_deque *Worker = (__bb_task_deque *)Data;
+  bb_thread_pool *ThreadPool = Worker->ThreadPool;
+  __bb_CurrentWorker = Worker;
+
+#ifdef BB_PLATFORM_PROFILE
+  // thread name is "worker <index>"
+  char Digits[12];
+  int NumDigits = 0;
+  int Index = (int)(Worker - (__bb_task_deque *)ThreadPool->Deques);
+  do {
+    Digits[NumDigits++] = (char)('0' + Index % 10);
+    Index /= 10;
+  } while (Index > 0);
+
+  char Name[32] = "worker ";
+  int Length = 7;
+  while (NumDigits > 0)
+    Name[Length++] = Digits[--NumDigits];
+  Name[Length] = 0;
+  bb_ProfilerSetThreadName(Name);
+#endif
+
+  __bb_worker_task Task;
+  for (;;) {
+    bool Found = false;
+    for (int Spin = 0; Spin < __bb_ThreadPoolSpinCount && !Found; ++Spin) {
+      Found = __bb_FindTask(ThreadPool, Worker, &Task);
+      if (!Found)
+        bb_YieldProcessor();
+    }
+
+    if (!Found) {
+      // NOTE(Brajan): stop only when there is nothing left to run
+      if (bb_AtomicLoad(&ThreadPool->StopFlag))
+        return;
+
+      // NOTE(Brajan): read Signal before the last check, push after that check changes Signal
+      // so the wait returns immediately instead of missing the wake up
+      int Signal = bb_AtomicLoad(&ThreadPool->Signal);
+      bb_AtomicAdd(&ThreadPool->NumSleeping, 1);
+
+      Found = __bb_FindTask(ThreadPool, Worker, &Task);
+      if (!Found && !bb_AtomicLoad(&ThreadPool->StopFlag))
+        bb_WaitOnAddress(&ThreadPool->Signal, Signal);
+
+      bb_AtomicAdd(&ThreadPool->NumSleeping, -1);
+    }
+
+    if (Found) {
+      __bb_RunTask(&Task);
+    }
+  }
+}
+
+// NOTE(Brajan): frees whatever bb_CreateThreadPool got so far, workers have to be joined already
+static void
+__bb_FreeThreadPool(bb_thread_pool *ThreadPool) {
+  __bb_task_deque *Deques = (__bb_task_deque *)ThreadPool->Deques;
+  if (Deques) {
+    for (int Index = 0; Index < ThreadPool->NumWorkers; ++Index) {
+      bb_FreeMemory(Deques[Index].Tasks);
+    }
+  }
+
+  bb_FreeMemory(ThreadPool->Deques);
+  bb_FreeMemory(ThreadPool->Tasks);
+  bb_FreeMemory(ThreadPool->Workers);
+  ThreadPool->Deques = 0;
+  ThreadPool->Tasks = 0;
+  ThreadPool->Workers = 0;
+  ThreadPool->NumWorkers = 0;
+}
+
+int
+bb_CreateThreadPool(bb_thread_pool *ThreadPool, int NumWorkers, int MaxTasks) {
+  ThreadPool->Workers = 0;
+  ThreadPool->NumWorkers = 0;
+  ThreadPool->Deques = 0;
+  ThreadPool->Tasks = 0;
+  if (NumWorkers <= 0 || MaxTasks <= 0)
+    return 1;
+
+  // shared queue and per worker deques, capacity has to be power of two
+  long long Capacity = 1;
+  while (Capacity < MaxTasks)
+    Capacity <<= 1;
+
+  // NOTE(Brajan): bb_AllocateMemory takes int, every array has to fit in it
+  const size_t MaxSize = 0x7fffffff;
+  if (sizeof(__bb_task_queue_cell) * (size_t)Capacity > MaxSize || sizeof(__bb_worker_task) * (size_t)Capacity > MaxSize ||
+      sizeof(__bb_task_deque) * (size_t)NumWorkers > MaxSize || sizeof(bb_thread) * (size_t)NumWorkers > MaxSize)
+    return 1;
+
+  ThreadPool->Workers = (bb_thread *)bb_AllocateMemory((int)(sizeof(bb_thread) * NumWorkers));
+  __bb_task_queue_cell *Cells = (__bb_task_queue_cell *)bb_AllocateMemory((int)(sizeof(__bb_task_queue_cell) * Capacity));
+  __bb_task_deque *Deques = (__bb_task_deque *)bb_AllocateMemory((int)(sizeof(__bb_task_deque) * NumWorkers));
+  ThreadPool->Tasks = Cells;
+  ThreadPool->Deques = Deques;
+  ThreadPool->NumWorkers = NumWorkers;
+  if (ThreadPool->Workers == 0 || Cells == 0 || Deques == 0) {
+    __bb_FreeThreadPool(ThreadPool);
+    return 1;
+  }
+
+  for (long long Index = 0; Index < Capacity; ++Index) {
+    Cells[Index].Sequence = Index;
+  }
+  ThreadPool->TasksMask = Capacity - 1;
+  ThreadPool->TasksEnqueuePosition = 0;
+  ThreadPool->TasksDequeuePosition = 0;
+
+  // NOTE(Brajan): deques come zeroed, so the ones after a failed allocation have null Tasks
+  for (int Index = 0; Index < NumWorkers; ++Index) {
+    Deques[Index].Tasks = (__bb_worker_task *)bb_AllocateMemory((int)(sizeof(__bb_worker_task) * Capacity));
+    if (Deques[Index].Tasks == 0) {
+      __bb_FreeThreadPool(ThreadPool);
+      return 1;
+    }
+
+    Deques[Index].Mask = Capacity - 1;
+    Deques[Index].ThreadPool = ThreadPool;
+    Deques[Index].Random = 2654435761u * (unsigned int)(Index + 1);
+  }
+
+  ThreadPool->Signal = 0;
+  ThreadPool->NumSleeping = 0;
+  ThreadPool->StopFlag = 0;
+
+  // set up workers
+  for (int Index = 0; Index < NumWorkers; ++Index) {
+    if (!bb_CreateThread(&ThreadPool->Workers[Index], __bb_ThreadPoolWorker, &Deques[Index])) {
+      // NOTE(Brajan): nothing is queued yet, workers that started exit right after the stop
+      bb_StopThreadPool(ThreadPool);
+      for (int Started = 0; Started < Index; ++Started) {
+        bb_JoinThread(&ThreadPool->Workers[Started]);
+        bb_DestroyThread(&ThreadPool->Workers[Started]);
+      }
+      __bb_FreeThreadPool(ThreadPool);
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+void
+bb_DestroyThreadPool(bb_thread_pool *ThreadPool) {
+  if (ThreadPool == 0)
+    return;
+
+  bb_StopThreadPool(ThreadPool);
+  for (int Index = 0; Index < ThreadPool->NumWorkers; ++Index) {
+    bb_JoinThread(&ThreadPool->Workers[Index]);
+    bb_DestroyThread(&ThreadPool->Workers[Index]);
+  }
+
+  __bb_FreeThreadPool(ThreadPool);
+}
+
+void 
+bb_StopThreadPool(bb_thread_pool *ThreadPool) {
+  bb_AtomicStore(&ThreadPool->StopFlag, 1);
+  bb_AtomicAdd(&ThreadPool->Signal, 1);
+  bb_WakeAddressAll(&ThreadPool->Signal);
+}
+
+static int
+__bb_PushTask(bb_thread_pool *ThreadPool, __bb_worker_task Task) {
+  // NOTE(Brajan): workers push to their own deque, everyone else (or full deque) goes to shared queue
+  __bb_task_deque *Worker = __bb_CurrentWorker;
+  if (Worker == 0 || Worker->ThreadPool != ThreadPool || !__bb_PushTaskToDeque(Worker, Task)) {
+    if (!__bb_PushTaskToQueue(ThreadPool, Task))
+      return 1;
+  }
+
+  __bb_WakeWorker(ThreadPool);
+  return 0;
+}
+
+int
+bb_PushTaskToThreadPool(bb_thread_pool *ThreadPool, void(*Function)(void *), void *Data) {
+  __bb_worker_task Task;
+  Task.Function = Function;
+  Task.Data = Data;
+  Task.Group = 0;
+  return __bb_PushTask(ThreadPool, Task);
+}
+
+// task groups
+void
+bb_InitTaskGroup(bb_task_group *Group) {
+  Group->NumPending = 0;
+  Group->NumWaiting = 0;
+}
+
+int
+bb_PushTaskToGroup(bb_thread_pool *ThreadPool, bb_task_group *Group, void(*Function)(void *), void *Data) {
+  __bb_worker_task Task;
+  Task.Function = Function;
+  Task.Data = Data;
+  Task.Group = Group;
+
+  // NOTE(Brajan): count the task twice until it's queued and drop the extra one after push. That
+  // changes NumPending after the task is visible, so waiter that read it earlier doesn't park, and
+  // group stays alive while we look at NumWaiting.
+  bb_AtomicAdd(&Group->NumPending, 2);
+  if (__bb_PushTask(ThreadPool, Task) != 0) {
+    if (bb_AtomicAdd(&Group->NumPending, -2) == 2)
+      bb_WakeAddressAll(&Group->NumPending);
+    return 1;
+  }
+
+  bb_MemoryBarrier();
+  bool Waiting = bb_AtomicLoad(&Group->NumWaiting) > 0;
+  if (bb_AtomicAdd(&Group->NumPending, -1) == 1 || Waiting)
+    bb_WakeAddressAll(&Group->NumPending);
+  return 0;
+}
+
+void
+bb_WaitTaskGroup(bb_thread_pool *ThreadPool, bb_task_group *Group) {
+  __bb_task_deque *Worker = __bb_CurrentWorker;
+  if (Worker && Worker->ThreadPool != ThreadPool)
+    Worker = 0;
+
+  __bb_worker_task Task;
+  int Spin = 0;
+  for (;;) {
+    int NumPending = bb_AtomicLoad(&Group->NumPending);
+    if (NumPending == 0)
+      return;
+
+    // help with queued work instead of sleeping
+    if (__bb_FindTask(ThreadPool, Worker, &Task)) {
+      __bb_RunTask(&Task);
+      Spin = 0;
+      continue;
+    }
+
+    // NOTE(Brajan): nothing to help with, remaining tasks are running on other threads. Last task
+    // of the group wakes us when counter drops to zero, push to the group wakes us to help.
+    if (++Spin < __bb_ThreadPoolSpinCount) {
+      bb_YieldProcessor();
+    } else {
+      bb_AtomicAdd(&Group->NumWaiting, 1);
+      NumPending = bb_AtomicLoad(&Group->NumPending);
+      bool Found = NumPending != 0 && __bb_FindTask(ThreadPool, Worker, &Task);
+      if (NumPending != 0 && !Found)
+        bb_WaitOnAddress(&Group->NumPending, NumPending);
+      bb_AtomicAdd(&Group->NumWaiting, -1);
+
+      if (Found)
+        __bb_RunTask(&Task);
+      Spin = 0;
+    }
+  }
+}
+
+// parallel for
+struct __bb_parallel_for {
+  void (*Function)(int Begin, int End, void *Data);
+  void *Data;
+  // NOTE(Brajan): 64 bit so workers adding Grain past the end can't overflow near INT_MAX
+  volatile long long Next;
+  int End;
+  int Grain;
+};
+
+static void
+__bb_ParallelForTask(void *Data) {
+  __bb_parallel_for *For = (__bb_parallel_for *)Data;
+  for (;;) {
+    long long Begin = bb_AtomicAdd64(&For->Next, For->Grain);
+    if (Begin >= For->End)
+      return;
+
+    long long End = For->End - Begin > For->Grain ? Begin + For->Grain : For->End;
+    For->Function((int)Begin, (int)End, For->Data);
+  }
+}
+
+void
+bb_ParallelFor(bb_thread_pool *ThreadPool, int Begin, int End, int Grain,
+               void (*Function)(int Begin, int End, void *Data), void *Data) {
+  if (Begin >= End)
+    return;
+  if (Grain < 1)
+    Grain = 1;
+
+  __bb_parallel_for For;
+  For.Function = Function;
+  For.Data = Data;
+  For.Next = Begin;
+  For.End = End;
+  For.Grain = Grain;
+
+  // NOTE(Brajan): chunks are handed out from shared counter, so one task per worker is enough.
+  // Calling thread takes chunks too.
+  long long NumChunks = ((long long)End - Begin + Grain - 1) / Grain;
+  int NumTasks = NumChunks - 1 < ThreadPool->NumWorkers ? (int)(NumChunks - 1) : ThreadPool->NumWorkers;
+
+  bb_task_group Group;
+  bb_InitTaskGroup(&Group);
+  for (int Index = 0; Index < NumTasks; ++Index) {
+    if (bb_PushTaskToGroup(ThreadPool, &Group, __bb_ParallelForTask, &For) != 0)
+      break;
+  }
+
+  __bb_ParallelForTask(&For);
+  bb_WaitTaskGroup(ThreadPool, &Group);
+}
+
+// virtual arena
+void
+bb_CreateVirtualArena(bb_memory_arena *Arena, size_t ReserveSize, int Flags, size_t CommitGranularity) {
+  size_t PageSize = (Flags & bb_MemoryLargePages) ? bb_GetLargePageSize() : bb_GetPageSize();
+  if (CommitGranularity == 0)
+    CommitGranularity = (Flags & bb_MemoryLargePages) ? PageSize : 64 * 1024;
+  CommitGranularity = (CommitGranularity + PageSize - 1) / PageSize * PageSize;
+  ReserveSize = (ReserveSize + PageSize - 1) / PageSize * PageSize;
+
+  void *Base = bb_ReserveMemory(ReserveSize, Flags);
+  bb_Assert(Base != 0);
+
+  bb_InitializeArena(Arena, ReserveSize, Base);
+  Arena->CommittedSize = 0;
+  Arena->CommitGranularity = CommitGranularity;
+  Arena->Commit = bb_CommitMemory;
+}
+
+void
+bb_DestroyVirtualArena(bb_memory_arena *Arena) {
+  bb_ReleaseMemory(Arena->Base, Arena->Size);
+  Arena->Base = 0;
+  Arena->Size = 0;
+  Arena->Used = 0;
+  Arena->CommittedSize = 0;
+}
+
+// frame memory
+#ifndef BB_PLATFORM_FRAME_ARENA_SIZE
+#define BB_PLATFORM_FRAME_ARENA_SIZE bb_Megabytes(64)
+#endif
+
+struct __bb_frame_arena {
+  bb_memory_arena Arena;
+  int FrameIndex;
 
-#ifndef BB_TOOL_H_
-#error "Include bb_tool library!"
+  ~__bb_frame_arena();
+};
+
+static volatile int __bb_FrameIndex = 0;
+static thread_local __bb_frame_arena __bb_FrameArena;
+
+__bb_frame_arena::~__bb_frame_arena() {
+  if (Arena.Base != 0) {
+    bb_DestroyVirtualArena(&Arena);
+  }
+}
+
+bb_memory_arena *
+bb_GetFrameArena() {
+  if (__bb_FrameArena.Arena.Base == 0) {
+    bb_CreateVirtualArena(&__bb_FrameArena.Arena, BB_PLATFORM_FRAME_ARENA_SIZE, bb_MemoryDefault);
+  }
+
+  int FrameIndex = bb_AtomicLoad(&__bb_FrameIndex);
+  if (__bb_FrameArena.FrameIndex != FrameIndex) {
+    bb_ResetArena(&__bb_FrameArena.Arena);
+    __bb_FrameArena.FrameIndex = FrameIndex;
+  }
+
+  return &__bb_FrameArena.Arena;
+}
+
+void
+bb_NextFrame() {
+  bb_AtomicAdd(&__bb_FrameIndex, 1);
+}
+
+// cycle counter
+// NOTE(Brajan): frequency is kept as bits of the double, so it is read and published with 64-bit
+// atomics. Racing threads may both calibrate, only the first one stores its value and everybody
+// returns that one, so all conversions use the same frequency.
+static volatile long long __bb_CycleFrequencyBits = 0;
+
+union __bb_double_bits {
+  double Double;
+  long long Bits;
+};
+
+double
+bb_GetCycleFrequency() {
+  __bb_double_bits Result;
+  Result.Bits = bb_AtomicLoad64(&__bb_CycleFrequencyBits);
+  if (Result.Bits != 0)
+    return Result.Double;
+
+#if defined(BB_TOOL_X86)
+  long long Frequency = bb_GetPerformanceFrequency();
+  long long CounterStart = bb_GetPerformanceCounter();
+  unsigned long long CyclesStart = bb_ReadCycleCounter();
+
+  long long CounterEnd;
+  do {
+    CounterEnd = bb_GetPerformanceCounter();
+  } while (CounterEnd - CounterStart < Frequency / 100);
+  unsigned long long CyclesEnd = bb_ReadCycleCounter();
+
+  Result.Double = (double)(CyclesEnd - CyclesStart) * (double)Frequency / (double)(CounterEnd - CounterStart);
+#elif defined(__aarch64__) && !defined(_MSC_VER)
+  unsigned long long Frequency;
+  __asm__ volatile("mrs %0, cntfrq_el0" : "=r"(Frequency));
+  Result.Double = (double)Frequency;
+#else
+  Result.Double = (double)bb_GetPerformanceFrequency();
 #endif
 
-#define bb_NumKeys 256
-#define bb_NumButtons 128
+  long long Previous = bb_AtomicCompareExchange64(&__bb_CycleFrequencyBits, 0, Result.Bits);
+  if (Previous != 0)
+    Result.Bits = Previous;
 
-struct bb_platform_state {
-  bb_window Window;
+  return Result.Double;
+}
 
-  struct {
-    bool Keys[bb_NumKeys];
-    bool KeysDown[bb_NumKeys];
-    bool KeysUp[bb_NumKeys];
+double
+bb_CyclesToSeconds(unsigned long long Cycles) {
+  return (double)Cycles / bb_GetCycleFrequency();
+}
 
-    bool Buttons[bb_NumButtons];
-    bool ButtonsDown[bb_NumButtons];
-    bool ButtonsUp[bb_NumButtons];
+// profiler
+#ifdef BB_PLATFORM_PROFILE
+static_assert((BB_PLATFORM_PROFILE_RING_SIZE & (BB_PLATFORM_PROFILE_RING_SIZE - 1)) == 0,
+              "BB_PLATFORM_PROFILE_RING_SIZE has to be power of two");
 
-    int MouseX;
-    int MouseY;
+// NOTE(Brajan): only owner thread writes, readers load WritePosition and may only trust zones
+// that are still within ring size of it after copying them
+struct __bb_profile_ring {
+  __bb_profile_ring *Next;
+  unsigned int ThreadId;
+  char ThreadName[32];
 
-    int MouseMoveX;
-    int MouseMoveY;
-  } InputState;
+  volatile long long WritePosition;
+  bb_profile_zone Zones[BB_PLATFORM_PROFILE_RING_SIZE];
 };
 
-// ----------------------------------------------------------------------------
-// -----------------------------IMPLEMENTATION---------------------------------
-// ----------------------------------------------------------------------------
-#ifdef BB_PLATFORM_IMPLEMENTATION
+static __bb_profile_ring *__bb_ProfileRings = 0;
+static volatile int __bb_ProfileRingsLock = 0;
+static thread_local __bb_profile_ring *__bb_ProfileRing = 0;
+
+static __bb_profile_ring *
+__bb_GetProfileRing() {
+  __bb_profile_ring *Ring = __bb_ProfileRing;
+  if (Ring)
+    return Ring;
+
+  Ring = (__bb_profile_ring *)bb_AllocateMemory(sizeof(__bb_profile_ring));
+  Ring->ThreadId = bb_GetCurrentThreadId();
+  Ring->ThreadName[0] = 0;
+  Ring->WritePosition = 0;
+
+  // NOTE(Brajan): once per thread, spin lock is enough
+  while (bb_AtomicCompareExchange(&__bb_ProfileRingsLock, 0, 1) != 0)
+    bb_YieldProcessor();
+  Ring->Next = __bb_ProfileRings;
+  __bb_ProfileRings = Ring;
+  bb_AtomicStore(&__bb_ProfileRingsLock, 0);
+
+  __bb_ProfileRing = Ring;
+  return Ring;
+}
+
+void
+bb_ProfilerSetThreadName(const char *Name) {
+  __bb_profile_ring *Ring = __bb_GetProfileRing();
+
+  int Length = 0;
+  while (Name[Length] && Length < (int)sizeof(Ring->ThreadName) - 1) {
+    Ring->ThreadName[Length] = Name[Length];
+    ++Length;
+  }
+  Ring->ThreadName[Length] = 0;
+}
+
+void
+__bb_ProfilerRecordZone(const char *Name, unsigned long long Begin, unsigned long long End) {
+  __bb_profile_ring *Ring = __bb_GetProfileRing();
+
+  long long Position = Ring->WritePosition;
+  bb_profile_zone *Zone = &Ring->Zones[Position & (BB_PLATFORM_PROFILE_RING_SIZE - 1)];
+  Zone->Name = Name;
+  Zone->Begin = Begin;
+  Zone->End = End;
+  bb_AtomicStore64(&Ring->WritePosition, Position + 1);
+}
+
+// chrome trace
+#define __bb_TraceBufferSize (64 * 1024)
+#define __bb_TraceZonesBatch 1024
+
+struct __bb_trace_ring {
+  __bb_profile_ring *Ring;
+  long long End;
+};
+
+struct __bb_trace_dump {
+  bb_thread Thread;
+  bb_file File;
+  char Path[512];
+  __bb_trace_ring *Rings;
+  int NumRings;
+
+  char *Buffer;
+  int BufferSize;
+  bool Failed;
+};
+
+static __bb_trace_dump __bb_TraceDump;
+// NOTE(Brajan): 0 - idle, 1 - writing, 2 - done but thread not joined yet
+static volatile int __bb_TraceDumpState = 0;
+
+static void
+__bb_TraceFlush(__bb_trace_dump *Dump) {
+  if (Dump->BufferSize > 0 && !bb_WriteFile(&Dump->File, Dump->Buffer, Dump->BufferSize))
+    Dump->Failed = true;
+  Dump->BufferSize = 0;
+}
+
+inline void
+__bb_TracePutChar(__bb_trace_dump *Dump, char Character) {
+  if (Dump->BufferSize == __bb_TraceBufferSize)
+    __bb_TraceFlush(Dump);
+  Dump->Buffer[Dump->BufferSize++] = Character;
+}
+
+static void
+__bb_TraceWrite(__bb_trace_dump *Dump, const char *String) {
+  for (; *String; ++String)
+    __bb_TracePutChar(Dump, *String);
+}
+
+static void
+__bb_TraceWriteString(__bb_trace_dump *Dump, const char *String) {
+  static const char Hex[] = "0123456789abcdef";
+
+  __bb_TracePutChar(Dump, '"');
+  for (; *String; ++String) {
+    unsigned char Character = (unsigned char)*String;
+    if (Character == '"' || Character == '\\') {
+      __bb_TracePutChar(Dump, '\\');
+      __bb_TracePutChar(Dump, (char)Character);
+    } else if (Character < 0x20) {
+      __bb_TraceWrite(Dump, "\\u00");
+      __bb_TracePutChar(Dump, Hex[Character >> 4]);
+      __bb_TracePutChar(Dump, Hex[Character & 15]);
+    } else {
+      __bb_TracePutChar(Dump, (char)Character);
+    }
+  }
+  __bb_TracePutChar(Dump, '"');
+}
+
+static void
+__bb_TraceWriteNumber(__bb_trace_dump *Dump, unsigned long long Value) {
+  char Digits[20];
+  int NumDigits = 0;
+  do {
+    Digits[NumDigits++] = (char)('0' + Value % 10);
+    Value /= 10;
+  } while (Value > 0);
+
+  while (NumDigits > 0)
+    __bb_TracePutChar(Dump, Digits[--NumDigits]);
+}
+
+// NOTE(Brajan): trace times are microseconds, write them with nanosecond precision
+static void
+__bb_TraceWriteMicroseconds(__bb_trace_dump *Dump, unsigned long long Nanoseconds) {
+  __bb_TraceWriteNumber(Dump, Nanoseconds / 1000);
+  __bb_TracePutChar(Dump, '.');
+  __bb_TracePutChar(Dump, (char)('0' + (Nanoseconds / 100) % 10));
+  __bb_TracePutChar(Dump, (char)('0' + (Nanoseconds / 10) % 10));
+  __bb_TracePutChar(Dump, (char)('0' + Nanoseconds % 10));
+}
+
+static void
+__bb_TraceWriteEventStart(__bb_trace_dump *Dump, bool *First, const char *Name, unsigned int ThreadId) {
+  __bb_TraceWrite(Dump, *First ? "\n{\"name\":" : ",\n{\"name\":");
+  __bb_TraceWriteString(Dump, Name);
+  __bb_TraceWrite(Dump, ",\"pid\":1,\"tid\":");
+  __bb_TraceWriteNumber(Dump, ThreadId);
+  *First = false;
+}
+
+// NOTE(Brajan): copies Count zones from Position and returns how many of the first ones were
+// overwritten meanwhile. Owner may be writing slot of WritePosition right now, so only positions
+// above WritePosition - ring size were not touched while copying.
+static int
+__bb_TraceCopyZones(__bb_profile_ring *Ring, long long Position, int Count, bb_profile_zone *Zones) {
+  for (int Index = 0; Index < Count; ++Index)
+    Zones[Index] = Ring->Zones[(Position + Index) & (BB_PLATFORM_PROFILE_RING_SIZE - 1)];
+
+  bb_MemoryBarrier();
+  long long Oldest = bb_AtomicLoad64(&Ring->WritePosition) - BB_PLATFORM_PROFILE_RING_SIZE + 1;
+  if (Oldest <= Position)
+    return 0;
+  return Oldest - Position < Count ? (int)(Oldest - Position) : Count;
+}
+
+// NOTE(Brajan): zones between End - ring size and End are written, while the dump runs owner
+// threads keep recording and may overwrite the oldest of them, these are skipped
+static void
+__bb_TraceDumpThread(void *Data) {
+  __bb_trace_dump *Dump = (__bb_trace_dump *)Data;
+  double NanosecondsPerCycle = 1e9 / bb_GetCycleFrequency();
+
+  // NOTE(Brajan): truncating old capture can take milliseconds, that's why file is opened here
+  if (!bb_CreateFile(&Dump->File, Dump->Path)) {
+    Dump->Failed = true;
+    bb_FreeMemory(Dump->Buffer);
+    bb_FreeMemory(Dump->Rings);
+    bb_AtomicStore(&__bb_TraceDumpState, 2);
+    return;
+  }
+
+  // NOTE(Brajan): trace starts at the earliest zone that is still valid, zones that survive to
+  // the second pass were valid here too, so none of them is before BaseCycles
+  unsigned long long BaseCycles = ~0ull;
+  bb_profile_zone Zones[__bb_TraceZonesBatch];
+  for (int RingIndex = 0; RingIndex < Dump->NumRings; ++RingIndex) {
+    __bb_profile_ring *Ring = Dump->Rings[RingIndex].Ring;
+    long long End = Dump->Rings[RingIndex].End;
+    long long Position = End > BB_PLATFORM_PROFILE_RING_SIZE ? End - BB_PLATFORM_PROFILE_RING_SIZE : 0;
+    while (Position < End) {
+      int Count = End - Position < __bb_TraceZonesBatch ? (int)(End - Position) : __bb_TraceZonesBatch;
+      int Skip = __bb_TraceCopyZones(Ring, Position, Count, Zones);
+      for (int Index = Skip; Index < Count; ++Index) {
+        if (Zones[Index].Begin < BaseCycles)
+          BaseCycles = Zones[Index].Begin;
+      }
+
+      Position += Count;
+    }
+  }
+
+  bool First = true;
+  __bb_TraceWrite(Dump, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+
+  for (int RingIndex = 0; RingIndex < Dump->NumRings; ++RingIndex) {
+    __bb_profile_ring *Ring = Dump->Rings[RingIndex].Ring;
+    long long End = Dump->Rings[RingIndex].End;
+
+    if (Ring->ThreadName[0]) {
+      __bb_TraceWriteEventStart(Dump, &First, "thread_name", Ring->ThreadId);
+      __bb_TraceWrite(Dump, ",\"ph\":\"M\",\"args\":{\"name\":");
+      __bb_TraceWriteString(Dump, Ring->ThreadName);
+      __bb_TraceWrite(Dump, "}}");
+    }
+
+    long long Position = End > BB_PLATFORM_PROFILE_RING_SIZE ? End - BB_PLATFORM_PROFILE_RING_SIZE : 0;
+    while (Position < End) {
+      int Count = End - Position < __bb_TraceZonesBatch ? (int)(End - Position) : __bb_TraceZonesBatch;
+      int Skip = __bb_TraceCopyZones(Ring, Position, Count, Zones);
+      for (int Index = Skip; Index < Count; ++Index) {
+        bb_profile_zone *Zone = &Zones[Index];
+        __bb_TraceWriteEventStart(Dump, &First, Zone->Name, Ring->ThreadId);
+        __bb_TraceWrite(Dump, ",\"ph\":\"X\",\"ts\":");
+        __bb_TraceWriteMicroseconds(Dump, (unsigned long long)((double)(Zone->Begin - BaseCycles) * NanosecondsPerCycle + 0.5));
+        __bb_TraceWrite(Dump, ",\"dur\":");
+        __bb_TraceWriteMicroseconds(Dump, (unsigned long long)((double)(Zone->End - Zone->Begin) * NanosecondsPerCycle + 0.5));
+        __bb_TracePutChar(Dump, '}');
+      }
+
+      Position += Count;
+    }
+  }
+
+  __bb_TraceWrite(Dump, "\n]}\n");
+  __bb_TraceFlush(Dump);
+  bb_CloseFile(&Dump->File);
+
+  bb_FreeMemory(Dump->Buffer);
+  bb_FreeMemory(Dump->Rings);
+  bb_AtomicStore(&__bb_TraceDumpState, 2);
+}
+
+bool
+bb_ProfilerWaitTrace() {
+  __bb_trace_dump *Dump = &__bb_TraceDump;
+  if (bb_AtomicLoad(&__bb_TraceDumpState) == 0)
+    return !Dump->Failed;
+
+  bb_JoinThread(&Dump->Thread);
+  bb_DestroyThread(&Dump->Thread);
+  bb_AtomicStore(&__bb_TraceDumpState, 0);
+  return !Dump->Failed;
+}
+
+bool
+bb_ProfilerDumpTrace(const char *Path) {
+  __bb_trace_dump *Dump = &__bb_TraceDump;
+  int State = bb_AtomicLoad(&__bb_TraceDumpState);
+  if (State == 1)
+    return false;
+  if (State == 2)
+    bb_ProfilerWaitTrace();
 
+  int Length = 0;
+  while (Path[Length] && Length < (int)sizeof(Dump->Path) - 1) {
+    Dump->Path[Length] = Path[Length];
+    ++Length;
+  }
+  Dump->Path[Length] = 0;
+
+  // NOTE(Brajan): new rings are pushed to the front and never removed, so list behind the head is
+  // safe to walk without the lock
+  while (bb_AtomicCompareExchange(&__bb_ProfileRingsLock, 0, 1) != 0)
+    bb_YieldProcessor();
+  __bb_profile_ring *Rings = __bb_ProfileRings;
+  bb_AtomicStore(&__bb_ProfileRingsLock, 0);
+
+  int NumRings = 0;
+  for (__bb_profile_ring *Ring = Rings; Ring; Ring = Ring->Next)
+    ++NumRings;
+
+  Dump->Rings = (__bb_trace_ring *)bb_AllocateMemory(sizeof(__bb_trace_ring) * (NumRings + 1));
+  Dump->NumRings = 0;
+  for (__bb_profile_ring *Ring = Rings; Ring; Ring = Ring->Next) {
+    Dump->Rings[Dump->NumRings].Ring = Ring;
+    Dump->Rings[Dump->NumRings].End = bb_AtomicLoad64(&Ring->WritePosition);
+    ++Dump->NumRings;
+  }
+
+  Dump->Buffer = (char *)bb_AllocateMemory(__bb_TraceBufferSize);
+  Dump->BufferSize = 0;
+  Dump->Failed = false;
+
+  bb_AtomicStore(&__bb_TraceDumpState, 1);
+  if (!bb_CreateThread(&Dump->Thread, __bb_TraceDumpThread, Dump)) {
+    bb_FreeMemory(Dump->Buffer);
+    bb_FreeMemory(Dump->Rings);
+    bb_AtomicStore(&__bb_TraceDumpState, 0);
+    return false;
+  }
+
+  return true;
+}
+#endif
+
+// events queue
+static_assert((BB_PLATFORM_EVENT_QUEUE_SIZE & (BB_PLATFORM_EVENT_QUEUE_SIZE - 1)) == 0,
+              "BB_PLATFORM_EVENT_QUEUE_SIZE has to be power of two");
+
+// NOTE(Brajan): positions only grow, slot is Position & (Size - 1). Producer owns WritePosition,
+// consumer owns ReadPosition, each reads the other one with acquire
+struct __bb_events_queue {
+  volatile long long WritePosition;
+  char WritePadding[__bb_CacheLineSize - sizeof(long long)];
+  volatile long long ReadPosition;
+  char ReadPadding[__bb_CacheLineSize - sizeof(long long)];
+  volatile long long Dropped;
+  bb_event Events[BB_PLATFORM_EVENT_QUEUE_SIZE];
+};
+static __bb_events_queue __bb_EventsQueue;
+
+static void
+__bb_InsertEvent(bb_event Event) {
+  long long WritePosition = __bb_EventsQueue.WritePosition;
+  if (WritePosition - bb_AtomicLoad64(&__bb_EventsQueue.ReadPosition) >= BB_PLATFORM_EVENT_QUEUE_SIZE) {
+    bb_AtomicAdd64(&__bb_EventsQueue.Dropped, 1);
+    return;
+  }
+
+  __bb_EventsQueue.Events[WritePosition & (BB_PLATFORM_EVENT_QUEUE_SIZE - 1)] = Event;
+  bb_AtomicStore64(&__bb_EventsQueue.WritePosition, WritePosition + 1);
+}
+
+int
+bb_PullEvents(bb_event *Events, int MaxEvents) {
+  long long ReadPosition = __bb_EventsQueue.ReadPosition;
+  long long Available = bb_AtomicLoad64(&__bb_EventsQueue.WritePosition) - ReadPosition;
+  int Count = (Available < MaxEvents) ? (int)Available : MaxEvents;
+  if (Count <= 0)
+    return 0;
+
+  // NOTE(Brajan): copy in at most two pieces, before and after the end of the ring
+  int First = (int)(ReadPosition & (BB_PLATFORM_EVENT_QUEUE_SIZE - 1));
+  int FirstCount = BB_PLATFORM_EVENT_QUEUE_SIZE - First;
+  if (FirstCount > Count)
+    FirstCount = Count;
+  bb_CopyMemory(__bb_EventsQueue.Events + First, Events, FirstCount * sizeof(bb_event));
+  bb_CopyMemory(__bb_EventsQueue.Events, Events + FirstCount, (Count - FirstCount) * sizeof(bb_event));
+
+  bb_AtomicStore64(&__bb_EventsQueue.ReadPosition, ReadPosition + Count);
+  return Count;
+}
+
+bool
+bb_PullEvent(bb_event *Event) {
+  return bb_PullEvents(Event, 1) == 1;
+}
+
+long long
+bb_GetDroppedEventCount() {
+  return bb_AtomicLoad64(&__bb_EventsQueue.Dropped);
+}
+
+#ifndef BB_PLATFORM_NO_MAIN
+
+#ifndef BB_PLATFORM_HEADLESS
 #include "gl3w.h"
+#endif
 
 #ifdef BB_PLATFORM_INIT
 void BB_PLATFORM_INIT (bb_platform_state *PlatformState);
@@ -84,7 +1786,154 @@ void BB_PLATFORM_SHUTDOWN ();
 void BB_PLATFORM_PROCESSEVENT(bb_event *Event);
 #endif
 
+#ifdef BB_PLATFORM_FIXED_UPDATE
+void BB_PLATFORM_FIXED_UPDATE(float FixedDeltaTime);
+#endif
+
+#ifdef BB_PLATFORM_RENDER
+void BB_PLATFORM_RENDER(float Alpha);
+#endif
+
 static bb_platform_state bb_PlatformState;
+static int __bb_LastMousePositionX = 0;
+static int __bb_LastMousePositionY = 0;
+
+static void
+__bb_HandleEvent(bb_event *Event, bool *IsRunning) {
+  switch (Event->Type) {
+    case bb_EventQuit: {
+      *IsRunning = false;
+    } break;
+
+    case bb_EventKeyDown: {
+      bb_PlatformState.InputState.Keys[Event->Key] = true;
+      bb_PlatformState.InputState.KeysDown[Event->Key] = true;
+    } break;
+
+    case bb_EventKeyUp: {
+      bb_PlatformState.InputState.Keys[Event->Key] = false;
+      bb_PlatformState.InputState.KeysUp[Event->Key] = true;
+    } break;
+
+    case bb_EventButtonDown: {
+      bb_PlatformState.InputState.Buttons[Event->Button] = true;
+      bb_PlatformState.InputState.ButtonsDown[Event->Button] = true;
+    } break;
+
+    case bb_EventButtonUp: {
+      bb_PlatformState.InputState.Buttons[Event->Button] = false;
+      bb_PlatformState.InputState.ButtonsUp[Event->Button] = true;
+    } break;
+
+    case bb_EventMouseMove: {
+      bb_PlatformState.InputState.MouseX = Event->Mouse.X;
+      bb_PlatformState.InputState.MouseY = Event->Mouse.Y;
+
+      bb_PlatformState.InputState.MouseMoveX += __bb_LastMousePositionX - Event->Mouse.X;
+      bb_PlatformState.InputState.MouseMoveY += __bb_LastMousePositionY - Event->Mouse.Y;
+
+      __bb_LastMousePositionX = Event->Mouse.X;
+      __bb_LastMousePositionY = Event->Mouse.Y;
+    } break;
+
+    case bb_EventResized: {
+#ifdef BB_PLATFORM_CONFIG
+      BB_PLATFORM_CONFIG();
+#endif
+    } break;
+
+    default: {
+    } break;
+  }
+#ifdef BB_PLATFORM_PROCESSEVENT
+  BB_PLATFORM_PROCESSEVENT(Event);
+#endif
+}
+
+// NOTE(Brajan): drains the whole queue, so input is never more than a frame late. Runs of mouse
+// moves become one event with the last position (MouseMove holds the whole delta of the frame).
+static void
+__bb_HandleEvents(bool *IsRunning) {
+  bb_event Events[64];
+  bb_event MouseMove;
+  bool HasMouseMove = false;
+  int NumEvents = 0;
+  int NumMouseMoves = 0;
+
+  int Count;
+  do {
+    Count = bb_PullEvents(Events, bb_ArrayCount(Events));
+    NumEvents += Count;
+    for (int Index = 0; Index < Count; ++Index) {
+      if (Events[Index].Type == bb_EventMouseMove) {
+        MouseMove = Events[Index];
+        HasMouseMove = true;
+        ++NumMouseMoves;
+        continue;
+      }
+
+      if (HasMouseMove) {
+        __bb_HandleEvent(&MouseMove, IsRunning);
+        HasMouseMove = false;
+      }
+      __bb_HandleEvent(&Events[Index], IsRunning);
+    }
+  } while (Count == (int)bb_ArrayCount(Events));
+
+  if (HasMouseMove)
+    __bb_HandleEvent(&MouseMove, IsRunning);
+
+  bb_PlatformState.EventStats.NumEvents = NumEvents;
+  bb_PlatformState.EventStats.NumMouseMoves = NumMouseMoves;
+  bb_PlatformState.EventStats.NumDropped = bb_GetDroppedEventCount();
+}
+
+// frame stats
+#define __bb_FrameStatsCount 128
+
+static float __bb_FrameTimes[__bb_FrameStatsCount];
+static int __bb_NumFrameTimes = 0;
+static int __bb_FrameTimesPosition = 0;
+
+static void
+__bb_UpdateFrameStats(float FrameTime, float WorkTime) {
+  __bb_FrameTimes[__bb_FrameTimesPosition] = FrameTime;
+  __bb_FrameTimesPosition = (__bb_FrameTimesPosition + 1) % __bb_FrameStatsCount;
+  if (__bb_NumFrameTimes < __bb_FrameStatsCount)
+    ++__bb_NumFrameTimes;
+
+  // NOTE(Brajan): p99 by nearest rank, it's one of the few longest frames (second longest of 128),
+  // so keep only these sorted instead of sorting everything
+  int NumLongest = __bb_NumFrameTimes - (99 * __bb_NumFrameTimes + 99) / 100 + 1;
+  float Longest[__bb_FrameStatsCount / 100 + 1];
+  int NumFound = 0;
+
+  float Min = __bb_FrameTimes[0];
+  float Sum = 0.0f;
+  for (int Index = 0; Index < __bb_NumFrameTimes; ++Index) {
+    float Time = __bb_FrameTimes[Index];
+    Min = bb_Min(Min, Time);
+    Sum += Time;
+
+    if (NumFound < NumLongest)
+      ++NumFound;
+    else if (Time <= Longest[NumFound - 1])
+      continue;
+
+    int Position = NumFound - 1;
+    while (Position > 0 && Longest[Position - 1] < Time) {
+      Longest[Position] = Longest[Position - 1];
+      --Position;
+    }
+    Longest[Position] = Time;
+  }
+
+  bb_PlatformState.FrameStats.FrameTime = FrameTime;
+  bb_PlatformState.FrameStats.WorkTime = WorkTime;
+  bb_PlatformState.FrameStats.MinFrameTime = Min;
+  bb_PlatformState.FrameStats.AverageFrameTime = Sum / (float)__bb_NumFrameTimes;
+  bb_PlatformState.FrameStats.P99FrameTime = Longest[NumLongest - 1];
+}
 
 #ifdef BB_PLATFORM_WIN32
 int CALLBACK
@@ -103,99 +1952,129 @@ main(int ArgumentsNumber, char **Arguments) {
   bb_OpenWindow(&bb_PlatformState.Window, "Voxel Engine", 0, 0, 1024, 576, bb_FlagDefault | bb_FlagResizable);
   bb_CreateOpenGLContext(&bb_PlatformState.Window, &OpenGLContext);
 
+#ifndef BB_PLATFORM_HEADLESS
   // gl3w
   gl3wInit();
+#endif
+
+  bb_ProfilerSetThreadName("main");
+
+  bb_PlatformState.FixedUpdate.TickRate = (float)BB_PLATFORM_FIXED_UPDATE_RATE;
+  bb_PlatformState.FixedUpdate.MaxSteps = BB_PLATFORM_FIXED_UPDATE_MAX_STEPS;
+  bb_PlatformState.FramePacing.TargetFrameRate = (float)BB_PLATFORM_TARGET_FRAME_RATE;
 
   // game init
 #ifdef BB_PLATFORM_INIT
   BB_PLATFORM_INIT(&bb_PlatformState);
 #endif
 
-  int LastMousePositionX = 0;
-  int LastMousePositionY = 0;
-
-  unsigned int EndTime = 0;
+  double LastTime = bb_GetTimeSeconds();
   float DeltaTime = 0.0f;
+#ifdef BB_PLATFORM_FIXED_UPDATE
+  double FixedAccumulator = 0.0;
+#endif
+  double NextFrameTime = LastTime;
+  double WorkEstimate = 0.0;
 
   while (IsRunning) {
-    bb_UpdateWindow(&bb_PlatformState.Window);
+    // frame pacing
+    // NOTE(Brajan): frames go on a fixed schedule, if frame is late schedule moves instead of
+    // catching up. Schedule says when frame starts, with late input sampling it says when frame is
+    // presented and frame starts WorkEstimate (peak work time decaying slowly) + 1ms earlier.
+    if (bb_PlatformState.FramePacing.TargetFrameRate > 0.0f) {
+      BB_PROFILE_SCOPE("frame pacing");
+      double FramePeriod = 1.0 / (double)bb_PlatformState.FramePacing.TargetFrameRate;
+      double Lead = bb_PlatformState.FramePacing.LateInputSampling ? WorkEstimate + 0.001 : 0.0;
 
-    // reset keys & buttons
-    for (int Index = 0; Index < bb_NumKeys; ++Index) {
-      bb_PlatformState.InputState.KeysUp[Index] = false;
-      bb_PlatformState.InputState.KeysDown[Index] = false;
+      NextFrameTime += FramePeriod;
+      double Now = bb_GetTimeSeconds();
+      if (NextFrameTime - Lead < Now)
+        NextFrameTime = Now + Lead;
+      bb_WaitUntil(NextFrameTime - Lead);
     }
 
-    for (int Index = 0; Index < bb_NumButtons; ++Index) {
-      bb_PlatformState.InputState.ButtonsUp[Index] = false;
-      bb_PlatformState.InputState.ButtonsDown[Index] = false;
-    }
-    bb_PlatformState.InputState.MouseMoveX = 0;
-    bb_PlatformState.InputState.MouseMoveY = 0;
+    double WorkStartTime = bb_GetTimeSeconds();
+    bb_NextFrame();
 
-    // handle events
-    bb_event Event;
-    if (bb_PullEvent(&Event)) {
-      switch (Event.Type) {
-        case bb_EventQuit: {
-          IsRunning = false;
-        } break;
+    {
+      BB_PROFILE_SCOPE("events");
+      bb_UpdateWindow(&bb_PlatformState.Window);
 
-        case bb_EventKeyDown: {
-          bb_PlatformState.InputState.Keys[Event.Key] = true;
-          bb_PlatformState.InputState.KeysDown[Event.Key] = true;
-        } break;
+      // reset keys & buttons
+      for (int Index = 0; Index < bb_NumKeys; ++Index) {
+        bb_PlatformState.InputState.KeysUp[Index] = false;
+        bb_PlatformState.InputState.KeysDown[Index] = false;
+      }
 
-        case bb_EventKeyUp: {
-          bb_PlatformState.InputState.Keys[Event.Key] = false;
-          bb_PlatformState.InputState.KeysUp[Event.Key] = true;
-        } break;
+      for (int Index = 0; Index < bb_NumButtons; ++Index) {
+        bb_PlatformState.InputState.ButtonsUp[Index] = false;
+        bb_PlatformState.InputState.ButtonsDown[Index] = false;
+      }
+      bb_PlatformState.InputState.MouseMoveX = 0;
+      bb_PlatformState.InputState.MouseMoveY = 0;
 
-        case bb_EventButtonDown: {
-          bb_PlatformState.InputState.Buttons[Event.Button] = true;
-          bb_PlatformState.InputState.ButtonsDown[Event.Button] = true;
-        } break;
+      // handle events
+      __bb_HandleEvents(&IsRunning);
+    }
 
-        case bb_EventButtonUp: {
-          bb_PlatformState.InputState.Buttons[Event.Button] = false;
-          bb_PlatformState.InputState.ButtonsUp[Event.Button] = true;
-        } break;
+    double Time = bb_GetTimeSeconds();
+    double FrameTime = Time - LastTime;
+    DeltaTime = (float)FrameTime;
+    LastTime = Time;
 
-        case bb_EventMouseMove: {
-          bb_PlatformState.InputState.MouseX = Event.Mouse.X;
-          bb_PlatformState.InputState.MouseY = Event.Mouse.Y;
+    // fixed update
+#ifdef BB_PLATFORM_FIXED_UPDATE
+    double FixedDeltaTime = 1.0 / (double)bb_PlatformState.FixedUpdate.TickRate;
+    FixedAccumulator += FrameTime;
 
-          bb_PlatformState.InputState.MouseMoveX = LastMousePositionX - Event.Mouse.X;
-          bb_PlatformState.InputState.MouseMoveY = LastMousePositionY - Event.Mouse.Y;
+    int NumSteps = 0;
+    while (FixedAccumulator >= FixedDeltaTime && NumSteps < bb_PlatformState.FixedUpdate.MaxSteps) {
+      BB_PROFILE_SCOPE("fixed update");
+      BB_PLATFORM_FIXED_UPDATE((float)FixedDeltaTime);
+      FixedAccumulator -= FixedDeltaTime;
+      ++NumSteps;
+    }
 
-          LastMousePositionX = Event.Mouse.X;
-          LastMousePositionY = Event.Mouse.Y;
-        } break;
+    if (FixedAccumulator >= FixedDeltaTime) {
+      long long NumSkippedSteps = (long long)(FixedAccumulator / FixedDeltaTime);
+      bb_PlatformState.FixedUpdate.NumSkippedSteps += NumSkippedSteps;
+      FixedAccumulator -= (double)NumSkippedSteps * FixedDeltaTime;
+    }
 
-        case bb_EventResized: {
-#ifdef BB_PLATFORM_CONFIG
-          BB_PLATFORM_CONFIG();
+    bb_PlatformState.FixedUpdate.NumSteps = NumSteps;
+    bb_PlatformState.FixedUpdate.Alpha = (float)(FixedAccumulator / FixedDeltaTime);
 #endif
-        } break;
 
-        default: {
-        } break;
-      }
-#ifdef BB_PLATFORM_PROCESSEVENT
-      BB_PLATFORM_PROCESSEVENT(&Event);
+    // game update and render
+#ifdef BB_PLATFORM_LOOP
+    {
+      BB_PROFILE_SCOPE("loop");
+      BB_PLATFORM_LOOP(DeltaTime);
+    }
 #endif
+
+#ifdef BB_PLATFORM_RENDER
+    {
+      BB_PROFILE_SCOPE("render");
+      BB_PLATFORM_RENDER(bb_PlatformState.FixedUpdate.Alpha);
     }
+#endif
 
-    unsigned int StartTime = bb_GetTicks();
-    DeltaTime = (float)(StartTime - EndTime) / 1000.0f;
-    EndTime = StartTime;
+    double WorkTime = bb_GetTimeSeconds() - WorkStartTime;
+    if (WorkTime > WorkEstimate)
+      WorkEstimate = WorkTime;
+    else
+      WorkEstimate += (WorkTime - WorkEstimate) * 0.02;
 
-    // game update and render
-#ifdef BB_PLATFORM_LOOP
-    BB_PLATFORM_LOOP(DeltaTime);
-#endif
+    if (bb_PlatformState.FramePacing.TargetFrameRate > 0.0f && bb_PlatformState.FramePacing.LateInputSampling)
+      bb_WaitUntil(NextFrameTime);
 
-    bb_OpenGLSwapBuffers(&OpenGLContext);
+    {
+      BB_PROFILE_SCOPE("swap");
+      bb_OpenGLSwapBuffers(&OpenGLContext);
+    }
+
+    __bb_UpdateFrameStats(DeltaTime, (float)WorkTime);
   }
 
 #ifdef BB_PLATFORM_SHUTDOWN
@@ -209,5 +2088,7 @@ main(int ArgumentsNumber, char **Arguments) {
 
 #endif
 
+#endif
+
 #define BB_PLATFORM_H_
 #endif
\ No newline at end of file
@@ -0,0 +1,652 @@
+#ifndef BB_PLATFORM_LINUX_H_
+
+// NOTE(Brajan): linux backend is headless for now - there is no window and no opengl context,
+// window functions are no-ops so simulation/worker code can run on servers. SIGINT and SIGTERM
+// are delivered as bb_EventQuit.
+#define BB_PLATFORM_HEADLESS
+
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+// keys & buttons
+enum {
+  bb_ButtonLeft       = 0x01,
+  bb_ButtonRight      = 0x02,
+  bb_ButtonMiddle     = 0x04,
+  bb_KeyBackspace     = 0x08,
+  bb_KeyTab           = 0x09,
+  bb_KeyClear         = 0x0C,
+  bb_KeyReturn        = 0x0D,
+  bb_KeyShift         = 0x10,
+  bb_KeyControl       = 0x11,
+  bb_KeyAlt           = 0x12,
+  bb_KeyPause         = 0x13,
+  bb_KeyCapslock      = 0x14,
+  bb_KeyEscape        = 0x1B,
+  bb_KeySpace         = 0x20,
+  bb_KeyPageup        = 0x21,
+  bb_KeyPagedown      = 0x22,
+  bb_KeyEnd           = 0x23,
+  bb_KeyHome          = 0x24,
+  bb_KeyLeft          = 0x25,
+  bb_KeyUp            = 0x26,
+  bb_KeyRight         = 0x27,
+  bb_KeyDown          = 0x28,
+  bb_KeySelect        = 0x29,
+  bb_KeyPrint         = 0x2A,
+  bb_KeyExecute       = 0x2B,
+  bb_KeyPrintScreen   = 0x2C, // print screen
+  bb_KeyInsert        = 0x2D,
+  bb_KeyDelete        = 0x2E,
+  bb_KeyHelp          = 0x2F,
+  bb_Key0             = 0x30,
+  bb_Key1             = 0x31,
+  bb_Key2             = 0x32,
+  bb_Key3             = 0x33,
+  bb_Key4             = 0x34,
+  bb_Key5             = 0x35,
+  bb_Key6             = 0x36,
+  bb_Key7             = 0x37,
+  bb_Key8             = 0x38,
+  bb_Key9             = 0x39,
+  bb_KeyA             = 0x41,
+  bb_KeyB             = 0x42,
+  bb_KeyC             = 0x43,
+  bb_KeyD             = 0x44,
+  bb_KeyE             = 0x45,
+  bb_KeyF             = 0x46,
+  bb_KeyG             = 0x47,
+  bb_KeyH             = 0x48,
+  bb_KeyI             = 0x49,
+  bb_KeyJ             = 0x4A,
+  bb_KeyK             = 0x4B,
+  bb_KeyL             = 0x4C,
+  bb_KeyM             = 0x4D,
+  bb_KeyN             = 0x4E,
+  bb_KeyO             = 0x4F,
+  bb_KeyP             = 0x50,
+  bb_KeyQ             = 0x51,
+  bb_KeyR             = 0x52,
+  bb_KeyS             = 0x53,
+  bb_KeyT             = 0x54,
+  bb_KeyU             = 0x55,
+  bb_KeyV             = 0x56,
+  bb_KeyW             = 0x57,
+  bb_KeyX             = 0x58,
+  bb_KeyY             = 0x59,
+  bb_KeyZ             = 0x5A,
+  bb_KeyNumpad0       = 0x60,
+  bb_KeyNumpad1       = 0x61,
+  bb_KeyNumpad2       = 0x62,
+  bb_KeyNumpad3       = 0x63,
+  bb_KeyNumpad4       = 0x64,
+  bb_KeyNumpad5       = 0x65,
+  bb_KeyNumpad6       = 0x66,
+  bb_KeyNumpad7       = 0x67,
+  bb_KeyNumpad8       = 0x68,
+  bb_KeyNumpad9       = 0x69,
+  bb_KeyMultiply      = 0x6A,
+  bb_KeyAdd           = 0x6B,
+  bb_KeySeparator     = 0x6C,
+  bb_KeySubtract      = 0x6D,
+  bb_KeyDecimal       = 0x6E,
+  bb_KeyDivide        = 0x6F,
+  bb_KeyF1            = 0x70,
+  bb_KeyF2            = 0x71,
+  bb_KeyF3            = 0x72,
+  bb_KeyF4            = 0x73,
+  bb_KeyF5            = 0x74,
+  bb_KeyF6            = 0x75,
+  bb_KeyF7            = 0x76,
+  bb_KeyF8            = 0x77,
+  bb_KeyF9            = 0x78,
+  bb_KeyF10           = 0x79,
+  bb_KeyF11           = 0x7A,
+  bb_KeyF12           = 0x7B,
+  bb_KeyF13           = 0x7C,
+  bb_KeyF14           = 0x7D,
+  bb_KeyF15           = 0x7E,
+  bb_KeyF16           = 0x7F,
+  bb_KeyF17           = 0x80,
+  bb_KeyF18           = 0x81,
+  bb_KeyF19           = 0x82,
+  bb_KeyF20           = 0x83,
+  bb_KeyF21           = 0x84,
+  bb_KeyF22           = 0x85,
+  bb_KeyF23           = 0x86,
+  bb_KeyF24           = 0x87,
+  bb_KeyNumlock       = 0x90,
+  bb_KeyScroll        = 0x91,
+  bb_KeyLeftShift     = 0xA0,
+  bb_KeyRightShift    = 0xA1,
+  bb_KeyLeftControl   = 0xA2,
+  bb_KeyRightControl  = 0xA3,
+  bb_KeyLeftAlt       = 0xA4,
+  bb_KeyRightAlt      = 0xA5
+};
+
+// events
+enum {
+  bb_EventUnknown = 0,
+  bb_EventQuit,
+  bb_EventKeyDown,
+  bb_EventKeyUp,
+  bb_EventButtonDown,
+  bb_EventButtonUp,
+  bb_EventMouseMove,
+  bb_EventSetFocus,
+  bb_EventLostFocus,
+  bb_EventResized,
+  bb_EventMinimized,
+  bb_EventMaximized,
+  bb_EventMouseWheel,
+  bb_EventChar
+};
+
+// window flags
+enum {
+  bb_FlagNone       = 0,
+  bb_FlagTitlebar   = 1 << 0,
+  bb_FlagResizable  = 1 << 1,
+  bb_FlagClose      = 1 << 2,
+  bb_FlagFullscreen = 1 << 3,
+  bb_FlagDefault    = bb_FlagTitlebar | bb_FlagClose
+};
+
+struct bb_event {
+  int Type;
+  union {
+    struct { int X, Y; } Mouse;
+    struct { int Width, Height; } Window;
+    struct { int X, Y; } Wheel;
+    struct { char Character; };
+    int Key;
+    int Button;
+  };
+};
+
+struct bb_window {
+  int Width;
+  int Height;
+};
+
+struct bb_opengl_context {
+  bb_window *Window;
+};
+
+struct bb_thread {
+  pthread_t ThreadHandle;
+  unsigned int ThreadId;
+
+  void(*Function)(void *);
+  void *Data;
+};
+
+struct bb_file {
+  int Descriptor;
+};
+
+// window functions
+int bb_OpenWindow(bb_window *Window, const char *Title, int PositionX, int PositionY, int Width, int Height, int Flags);
+int bb_CloseWindow(bb_window *Window);
+void bb_UpdateWindow(bb_window *Window);
+void bb_SetWindowCursorPosition(bb_window *Window, int X, int Y);
+void bb_SetWindowTitle(bb_window *Window, const char *Title);
+void bb_GetWindowSize(bb_window *Window, int *Width, int *Height);
+void bb_ShowCursor(bool Show);
+bool bb_GetAsyncKeyState(int Key);
+void bb_GetScreenMousePosition(int *X, int *Y);
+void bb_GetClientMousePosition(bb_window *Window, int *X, int *Y);
+
+// time
+// NOTE(Brajan): performance counter is monotonic and ticks bb_GetPerformanceFrequency times per
+// second. bb_GetTicks (milliseconds) and bb_GetTimeSeconds count from the first call to either.
+unsigned int bb_GetTicks();
+long long bb_GetPerformanceCounter();
+long long bb_GetPerformanceFrequency();
+double bb_GetTimeSeconds();
+// NOTE(Brajan): waits until bb_GetTimeSeconds reaches Time, sleeps on the os timer and spins
+// the last bit (timer wakes up late, spinning doesn't)
+void bb_WaitUntil(double Time);
+
+// opengl context
+int bb_CreateOpenGLContext(bb_window *Window, bb_opengl_context *Context);
+int bb_DestroyOpenGLContext(bb_opengl_context *Context);
+void bb_OpenGLSwapBuffers(bb_opengl_context *Context);
+
+// memory
+// NOTE(Brajan): memory comes zeroed, 0 when the os is out of memory
+void *bb_AllocateMemory(int Size);
+void bb_FreeMemory(void *Memory);
+
+// virtual memory
+// NOTE(Brajan): reserve address space once and commit pages as you need them, so memory never moves.
+// bb_MemoryLargePages asks for 2MB pages, if system doesn't give them you get normal ones. With large
+// pages Size should be multiple of bb_GetLargePageSize().
+enum {
+  bb_MemoryDefault    = 0,
+  bb_MemoryLargePages = 1 << 0
+};
+
+void *bb_ReserveMemory(size_t Size, int Flags);
+bool bb_CommitMemory(void *Memory, size_t Size);
+void bb_DecommitMemory(void *Memory, size_t Size);
+void bb_ReleaseMemory(void *Memory, size_t Size);
+size_t bb_GetPageSize();
+size_t bb_GetLargePageSize();
+
+// threads
+int bb_CreateThread(bb_thread *Thread, void (*Function)(void *), void *Data);
+void bb_DestroyThread(bb_thread *Thread);
+void bb_JoinThread(bb_thread *Thread);
+// NOTE(Brajan): same id as bb_thread::ThreadId
+unsigned int bb_GetCurrentThreadId();
+
+// atomics
+inline int bb_AtomicLoad(volatile int *Value) { return __atomic_load_n(Value, __ATOMIC_ACQUIRE); }
+inline void bb_AtomicStore(volatile int *Value, int NewValue) { __atomic_store_n(Value, NewValue, __ATOMIC_RELEASE); }
+inline int bb_AtomicAdd(volatile int *Value, int Addend) { return __atomic_fetch_add(Value, Addend, __ATOMIC_SEQ_CST); }
+inline int bb_AtomicExchange(volatile int *Value, int NewValue) { return __atomic_exchange_n(Value, NewValue, __ATOMIC_SEQ_CST); }
+inline int bb_AtomicCompareExchange(volatile int *Value, int Expected, int NewValue) { __atomic_compare_exchange_n(Value, &Expected, NewValue, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST); return Expected; }
+inline long long bb_AtomicLoad64(volatile long long *Value) { return __atomic_load_n(Value, __ATOMIC_ACQUIRE); }
+inline void bb_AtomicStore64(volatile long long *Value, long long NewValue) { __atomic_store_n(Value, NewValue, __ATOMIC_RELEASE); }
+inline long long bb_AtomicAdd64(volatile long long *Value, long long Addend) { return __atomic_fetch_add(Value, Addend, __ATOMIC_SEQ_CST); }
+inline long long bb_AtomicCompareExchange64(volatile long long *Value, long long Expected, long long NewValue) { __atomic_compare_exchange_n(Value, &Expected, NewValue, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST); return Expected; }
+inline void bb_MemoryBarrier() { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+#if defined(__i386__) || defined(__x86_64__)
+inline void bb_YieldProcessor() { __builtin_ia32_pause(); }
+#else
+inline void bb_YieldProcessor() { __asm__ __volatile__("" ::: "memory"); }
+#endif
+
+// waiting on address (futex)
+void bb_WaitOnAddress(volatile int *Address, int Expected);
+void bb_WakeAddressSingle(volatile int *Address);
+void bb_WakeAddressAll(volatile int *Address);
+
+// files
+// NOTE(Brajan): write only for now, bb_CreateFile creates new file or truncates existing one
+bool bb_CreateFile(bb_file *File, const char *Path);
+bool bb_WriteFile(bb_file *File, const void *Data, int Size);
+void bb_CloseFile(bb_file *File);
+
+// system
+void bb_Sleep(int Ms);
+void bb_SetTextClipboard(const char *Data, unsigned int Length);
+char *bb_GetTextClipboard();
+
+// ----------------------------------------------------------------------------
+// -----------------------------IMPLEMENTATION---------------------------------
+// ----------------------------------------------------------------------------
+#ifdef BB_PLATFORM_IMPLEMENTATION
+
+// NOTE(Brajan): events queue is in bb_platform.h
+static void __bb_InsertEvent(bb_event Event);
+
+static volatile sig_atomic_t __bb_QuitRequested = 0;
+
+static void
+__bb_LinuxHandleSignal(int) {
+  __bb_QuitRequested = 1;
+}
+
+// window
+int
+bb_OpenWindow(bb_window *Window, const char *, int, int, int Width, int Height, int) {
+  Window->Width = Width;
+  Window->Height = Height;
+
+  struct sigaction Action = {};
+  Action.sa_handler = __bb_LinuxHandleSignal;
+  sigemptyset(&Action.sa_mask);
+  sigaction(SIGINT, &Action, 0);
+  sigaction(SIGTERM, &Action, 0);
+  return 0;
+}
+
+int
+bb_CloseWindow(bb_window *) {
+  return 0;
+}
+
+void
+bb_UpdateWindow(bb_window *) {
+  if (__bb_QuitRequested) {
+    __bb_QuitRequested = 0;
+
+    bb_event Event = {};
+    Event.Type = bb_EventQuit;
+    __bb_InsertEvent(Event);
+  }
+}
+
+void
+bb_SetWindowCursorPosition(bb_window *, int, int) {
+}
+
+void
+bb_SetWindowTitle(bb_window *, const char *) {
+}
+
+void
+bb_GetWindowSize(bb_window *Window, int *Width, int *Height) {
+  *Width = Window->Width;
+  *Height = Window->Height;
+}
+
+void
+bb_ShowCursor(bool) {
+}
+
+bool
+bb_GetAsyncKeyState(int) {
+  return false;
+}
+
+void
+bb_GetScreenMousePosition(int *X, int *Y) {
+  *X = 0;
+  *Y = 0;
+}
+
+void
+bb_GetClientMousePosition(bb_window *, int *X, int *Y) {
+  *X = 0;
+  *Y = 0;
+}
+
+// time
+// NOTE(Brajan): CLOCK_MONOTONIC_RAW is not slewed by ntp, counter is in nanoseconds
+static volatile long long __bb_TimerStart = 0;
+
+long long
+bb_GetPerformanceCounter() {
+  struct timespec Now;
+  clock_gettime(CLOCK_MONOTONIC_RAW, &Now);
+  return (long long)Now.tv_sec * 1000000000LL + Now.tv_nsec;
+}
+
+long long
+bb_GetPerformanceFrequency() {
+  return 1000000000LL;
+}
+
+static long long
+__bb_GetTimerElapsed() {
+  long long Now = bb_GetPerformanceCounter();
+  long long Start = bb_AtomicLoad64(&__bb_TimerStart);
+  if (Start == 0) {
+    // NOTE(Brajan): 0 means not started yet (counter is never 0 after boot), first caller sets
+    // the start and everybody else uses it. Now of a thread that lost can be a bit older than Start.
+    Start = bb_AtomicCompareExchange64(&__bb_TimerStart, 0, Now);
+    if (Start == 0)
+      Start = Now;
+  }
+
+  return (Now > Start) ? Now - Start : 0;
+}
+
+unsigned int
+bb_GetTicks() {
+  return (unsigned int)(__bb_GetTimerElapsed() / 1000000LL);
+}
+
+double
+bb_GetTimeSeconds() {
+  return (double)__bb_GetTimerElapsed() * 1e-9;
+}
+
+// NOTE(Brajan): clock_nanosleep is usually late by 50-100us
+#define __bb_WaitSpinTime 0.0002
+
+void
+bb_WaitUntil(double Time) {
+  // NOTE(Brajan): Time is on the CLOCK_MONOTONIC_RAW counter, but the sleep is on CLOCK_MONOTONIC.
+  // Remaining time becomes an absolute deadline read from CLOCK_MONOTONIC itself, so sleep after
+  // a signal continues to the same deadline.
+  double SleepTime = Time - bb_GetTimeSeconds() - __bb_WaitSpinTime;
+  if (SleepTime > 0.0) {
+    struct timespec Deadline;
+    clock_gettime(CLOCK_MONOTONIC, &Deadline);
+    long long Nanoseconds = Deadline.tv_nsec + (long long)(SleepTime * 1e9);
+    Deadline.tv_sec += (time_t)(Nanoseconds / 1000000000LL);
+    Deadline.tv_nsec = (long)(Nanoseconds % 1000000000LL);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &Deadline, 0) == EINTR) {
+    }
+  }
+
+  while (bb_GetTimeSeconds() < Time)
+    bb_YieldProcessor();
+}
+
+// opengl context
+int
+bb_CreateOpenGLContext(bb_window *Window, bb_opengl_context *Context) {
+  Context->Window = Window;
+  return 0;
+}
+
+int
+bb_DestroyOpenGLContext(bb_opengl_context *Context) {
+  Context->Window = 0;
+  return 0;
+}
+
+void
+bb_OpenGLSwapBuffers(bb_opengl_context *) {
+}
+
+// memory
+// NOTE(Brajan): pages for the allocator in bb_platform.h, they have to be aligned to 64KB like
+// VirtualAlloc on windows, so map a bit more and unmap what sticks out
+#define __bb_PageAlignment (64 * 1024)
+#define __bb_LargePageSize (2 * 1024 * 1024)
+
+// NOTE(Brajan): Size has to be multiple of page size, Alignment power of two
+static void *
+__bb_MapAligned(size_t Size, size_t Alignment, int Protection, int Flags) {
+  size_t MappingSize = Size + Alignment;
+  char *Mapping = (char *)mmap(0, MappingSize, Protection, MAP_PRIVATE | MAP_ANONYMOUS | Flags, -1, 0);
+  if (Mapping == MAP_FAILED)
+    return 0;
+
+  size_t Offset = (Alignment - ((size_t)Mapping & (Alignment - 1))) & (Alignment - 1);
+  if (Offset)
+    munmap(Mapping, Offset);
+  if (Alignment - Offset)
+    munmap(Mapping + Offset + Size, Alignment - Offset);
+
+  return Mapping + Offset;
+}
+
+static void *
+__bb_AllocatePages(size_t Size) {
+  void *Memory = __bb_MapAligned(Size, __bb_PageAlignment, PROT_READ | PROT_WRITE, 0);
+  return Memory;
+}
+
+static void
+__bb_FreePages(void *Memory, size_t Size) {
+  munmap(Memory, Size);
+}
+
+// virtual memory
+// NOTE(Brajan): large pages try hugetlbfs pages first (they have to be set up by admin), then fall back
+// to 2MB aligned normal mapping with transparent huge pages enabled on it
+void *
+bb_ReserveMemory(size_t Size, int Flags) {
+  if (Flags & bb_MemoryLargePages) {
+    size_t LargeSize = (Size + __bb_LargePageSize - 1) & ~(size_t)(__bb_LargePageSize - 1);
+    // NOTE(Brajan): no MAP_NORESERVE here, huge pages get reserved up front, otherwise touching
+    // memory when pool is empty is SIGBUS
+    void *Memory = mmap(0, LargeSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (Memory != MAP_FAILED)
+      return Memory;
+
+    Memory = __bb_MapAligned(LargeSize, __bb_LargePageSize, PROT_NONE, MAP_NORESERVE);
+    if (Memory)
+      madvise(Memory, LargeSize, MADV_HUGEPAGE);
+    return Memory;
+  }
+
+  void *Memory = mmap(0, Size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  return Memory != MAP_FAILED ? Memory : 0;
+}
+
+bool
+bb_CommitMemory(void *Memory, size_t Size) {
+  return mprotect(Memory, Size, PROT_READ | PROT_WRITE) == 0;
+}
+
+void
+bb_DecommitMemory(void *Memory, size_t Size) {
+  madvise(Memory, Size, MADV_DONTNEED);
+  mprotect(Memory, Size, PROT_NONE);
+}
+
+void
+bb_ReleaseMemory(void *Memory, size_t Size) {
+  munmap(Memory, Size);
+}
+
+size_t
+bb_GetPageSize() {
+  return (size_t)sysconf(_SC_PAGESIZE);
+}
+
+size_t
+bb_GetLargePageSize() {
+  return __bb_LargePageSize;
+}
+
+// threads
+static void *
+__bb_ThreadEntryPoint(void *Data) {
+  bb_thread *Thread = (bb_thread *)Data;
+  Thread->ThreadId = (unsigned int)syscall(SYS_gettid);
+  Thread->Function(Thread->Data);
+  return 0;
+}
+
+int
+bb_CreateThread(bb_thread *Thread, void (*Function)(void *), void *Data) {
+  Thread->Function = Function;
+  Thread->Data = Data;
+
+  Thread->ThreadId = 0;
+  if (pthread_create(&Thread->ThreadHandle, 0, &__bb_ThreadEntryPoint, Thread) == 0)
+    return 1;
+  return 0;
+}
+
+void
+bb_DestroyThread(bb_thread *Thread) {
+  if (Thread->ThreadHandle)
+    pthread_detach(Thread->ThreadHandle);
+}
+
+void
+bb_JoinThread(bb_thread *Thread) {
+  if (Thread->ThreadHandle) {
+    pthread_join(Thread->ThreadHandle, 0);
+    Thread->ThreadHandle = 0;
+  }
+}
+
+unsigned int
+bb_GetCurrentThreadId() {
+  return (unsigned int)syscall(SYS_gettid);
+}
+
+// waiting on address (futex)
+void
+bb_WaitOnAddress(volatile int *Address, int Expected) {
+  syscall(SYS_futex, Address, FUTEX_WAIT_PRIVATE, Expected, 0, 0, 0);
+}
+
+void
+bb_WakeAddressSingle(volatile int *Address) {
+  syscall(SYS_futex, Address, FUTEX_WAKE_PRIVATE, 1, 0, 0, 0);
+}
+
+void
+bb_WakeAddressAll(volatile int *Address) {
+  syscall(SYS_futex, Address, FUTEX_WAKE_PRIVATE, 0x7FFFFFFF, 0, 0, 0);
+}
+
+// files
+bool
+bb_CreateFile(bb_file *File, const char *Path) {
+  File->Descriptor = open(Path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  return File->Descriptor >= 0;
+}
+
+bool
+bb_WriteFile(bb_file *File, const void *Data, int Size) {
+  const char *Bytes = (const char *)Data;
+  while (Size > 0) {
+    ssize_t Written = write(File->Descriptor, Bytes, (size_t)Size);
+    if (Written < 0) {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+
+    Bytes += Written;
+    Size -= (int)Written;
+  }
+
+  return true;
+}
+
+void
+bb_CloseFile(bb_file *File) {
+  if (File->Descriptor >= 0)
+    close(File->Descriptor);
+  File->Descriptor = -1;
+}
+
+// system
+void
+bb_Sleep(int Ms) {
+  struct timespec Duration;
+  Duration.tv_sec = Ms / 1000;
+  Duration.tv_nsec = (long)(Ms % 1000) * 1000000;
+  while (nanosleep(&Duration, &Duration) != 0);
+}
+
+static char *__bb_Clipboard = 0;
+
+void
+bb_SetTextClipboard(const char *Data, unsigned int Length) {
+  bb_FreeMemory(__bb_Clipboard);
+
+  __bb_Clipboard = (char *)bb_AllocateMemory(Length + 1);
+  for (unsigned int Index = 0; Index < Length; ++Index) {
+    __bb_Clipboard[Index] = Data[Index];
+  }
+  __bb_Clipboard[Length] = '\0';
+}
+
+char *
+bb_GetTextClipboard() {
+  if (__bb_Clipboard == 0)
+    return 0;
+
+  int Length = bb_StringLength(__bb_Clipboard);
+  char *Result = (char *)bb_AllocateMemory(Length + 1);
+  bb_StringCopy(Result, __bb_Clipboard);
+  return Result;
+}
+
+#endif
+
+#define BB_PLATFORM_LINUX_H_
+#endif
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <Windows.h>
 #include <windowsx.h>
 #include <process.h>
+#include <intrin.h>
 
 // keys & buttons
 enum {
@@ -180,21 +181,8 @@ struct bb_thread {
   void *Data;
 };
 
-struct bb_mutex {
-  HANDLE MutexHandle;
-};
-
-struct bb_thread_pool {
-  bb_thread *Workers;
-  int NumWorkers;
-
-  // NOTE(Brajan): do not set these variables manually
-  void *Tasks;
-  int NumTasks;
-  int TasksCapacity;
-
-  bb_mutex Mutex;
-  volatile bool StopFlag;
+struct bb_file {
+  HANDLE Handle;
 };
 
 // window functions
@@ -209,11 +197,16 @@ bool bb_GetAsyncKeyState(int Key);
 void bb_GetScreenMousePosition(int *X, int *Y);
 void bb_GetClientMousePosition(bb_window *Window, int *X, int *Y);
 
-// events
-bool bb_PullEvent(bb_event *Event);
-
 // time
+// NOTE(Brajan): performance counter is monotonic and ticks bb_GetPerformanceFrequency times per
+// second. bb_GetTicks (milliseconds) and bb_GetTimeSeconds count from the first call to either.
 unsigned int bb_GetTicks();
+long long bb_GetPerformanceCounter();
+long long bb_GetPerformanceFrequency();
+double bb_GetTimeSeconds();
+// NOTE(Brajan): waits until bb_GetTimeSeconds reaches Time, sleeps on the os timer and spins
+// the last bit (timer wakes up late, spinning doesn't)
+void bb_WaitUntil(double Time);
 
 // opengl context
 int bb_CreateOpenGLContext(bb_window *Window, bb_opengl_context *Context);
@@ -221,25 +214,69 @@ int bb_DestroyOpenGLContext(bb_opengl_context *Context);
 void bb_OpenGLSwapBuffers(bb_opengl_context *Context);
 
 // memory
+// NOTE(Brajan): memory comes zeroed, 0 when the os is out of memory
 void *bb_AllocateMemory(int Size);
 void bb_FreeMemory(void *Memory);
 
+// virtual memory
+// NOTE(Brajan): reserve address space once and commit pages as you need them, so memory never moves.
+// bb_MemoryLargePages asks for 2MB pages, if system doesn't give them you get normal ones. With large
+// pages Size should be multiple of bb_GetLargePageSize().
+enum {
+  bb_MemoryDefault    = 0,
+  bb_MemoryLargePages = 1 << 0
+};
+
+void *bb_ReserveMemory(size_t Size, int Flags);
+bool bb_CommitMemory(void *Memory, size_t Size);
+void bb_DecommitMemory(void *Memory, size_t Size);
+void bb_ReleaseMemory(void *Memory, size_t Size);
+size_t bb_GetPageSize();
+size_t bb_GetLargePageSize();
+
 // threads
 int bb_CreateThread(bb_thread *Thread, void (*Function)(void *), void *Data);
 void bb_DestroyThread(bb_thread *Thread);
-
-// mutex
-int bb_CreateMutex(bb_mutex *Mutex);
-void bb_DestroyMutex(bb_mutex *Mutex);
-void bb_Lock(bb_mutex *Mutex);
-void bb_Unlock(bb_mutex *Mutex);
-bool bb_TryLock(bb_mutex *Mutex);
-
-// thread pool
-int bb_CreateThreadPool(bb_thread_pool *ThreadPool, int NumWorkers, int MaxTasks);
-void bb_DestroyThreadPool(bb_thread_pool *ThreadPool);
-void bb_StopThreadPool(bb_thread_pool *ThreadPool);
-int bb_PushTaskToThreadPool(bb_thread_pool *ThreadPool, void(*Function)(void *), void *Data);
+void bb_JoinThread(bb_thread *Thread);
+// NOTE(Brajan): same id as bb_thread::ThreadId
+unsigned int bb_GetCurrentThreadId();
+
+// atomics
+// NOTE(Brajan): aligned volatile loads/stores are acquire/release on x86/x64, _ReadWriteBarrier only
+// stops the compiler from moving other accesses around them. ARM64 (msvc defaults to /volatile:iso
+// there) needs real barriers, dmb ish after the load and before the store. Interlocked functions are
+// full barriers everywhere.
+#if defined(_M_ARM64)
+inline int bb_AtomicLoad(volatile int *Value) { int Result = __iso_volatile_load32((const volatile __int32 *)Value); __dmb(_ARM64_BARRIER_ISH); return Result; }
+inline void bb_AtomicStore(volatile int *Value, int NewValue) { __dmb(_ARM64_BARRIER_ISH); __iso_volatile_store32((volatile __int32 *)Value, NewValue); }
+inline long long bb_AtomicLoad64(volatile long long *Value) { long long Result = __iso_volatile_load64((const volatile __int64 *)Value); __dmb(_ARM64_BARRIER_ISH); return Result; }
+inline void bb_AtomicStore64(volatile long long *Value, long long NewValue) { __dmb(_ARM64_BARRIER_ISH); __iso_volatile_store64((volatile __int64 *)Value, NewValue); }
+#elif defined(_M_X64) || defined(_M_IX86)
+inline int bb_AtomicLoad(volatile int *Value) { int Result = *Value; _ReadWriteBarrier(); return Result; }
+inline void bb_AtomicStore(volatile int *Value, int NewValue) { _ReadWriteBarrier(); *Value = NewValue; }
+inline long long bb_AtomicLoad64(volatile long long *Value) { long long Result = *Value; _ReadWriteBarrier(); return Result; }
+inline void bb_AtomicStore64(volatile long long *Value, long long NewValue) { _ReadWriteBarrier(); *Value = NewValue; }
+#else
+#error "bb_platform_win32.h: atomics are implemented for x86, x64 and ARM64 only"
+#endif
+inline int bb_AtomicAdd(volatile int *Value, int Addend) { return InterlockedExchangeAdd((volatile LONG *)Value, Addend); }
+inline int bb_AtomicExchange(volatile int *Value, int NewValue) { return InterlockedExchange((volatile LONG *)Value, NewValue); }
+inline int bb_AtomicCompareExchange(volatile int *Value, int Expected, int NewValue) { return InterlockedCompareExchange((volatile LONG *)Value, NewValue, Expected); }
+inline long long bb_AtomicAdd64(volatile long long *Value, long long Addend) { return InterlockedExchangeAdd64((volatile LONG64 *)Value, Addend); }
+inline long long bb_AtomicCompareExchange64(volatile long long *Value, long long Expected, long long NewValue) { return InterlockedCompareExchange64((volatile LONG64 *)Value, NewValue, Expected); }
+inline void bb_MemoryBarrier() { MemoryBarrier(); }
+inline void bb_YieldProcessor() { YieldProcessor(); }
+
+// waiting on address (WaitOnAddress, windows 8+)
+void bb_WaitOnAddress(volatile int *Address, int Expected);
+void bb_WakeAddressSingle(volatile int *Address);
+void bb_WakeAddressAll(volatile int *Address);
+
+// files
+// NOTE(Brajan): write only for now, bb_CreateFile creates new file or truncates existing one
+bool bb_CreateFile(bb_file *File, const char *Path);
+bool bb_WriteFile(bb_file *File, const void *Data, int Size);
+void bb_CloseFile(bb_file *File);
 
 // system
 void bb_Sleep(int Ms);
@@ -251,33 +288,13 @@ char *bb_GetTextClipboard();
 // ----------------------------------------------------------------------------
 #ifdef BB_PLATFORM_IMPLEMENTATION
 
-// events queue
-#define __bb_MaxEventsQueue 0xFF
-struct __bb_events_queue{
-  int Front;
-  int Rear;
-  int EventCount;
-  bb_event Array[__bb_MaxEventsQueue];
-};
-static __bb_events_queue __bb_EventsQueue = {
-  0, -1, 0, { }
-};
+// NOTE(Brajan): events queue is in bb_platform.h
+static void __bb_InsertEvent(bb_event Event);
 
 static bool __bb_IsResizing = false;
 static int __bb_LastWindowWidth = 0;
 static int __bb_LastWindowHeight = 0;
 
-static void
-__bb_InsertEvent(bb_event Event) {
-  if (__bb_EventsQueue.EventCount < __bb_MaxEventsQueue) {
-    if (__bb_EventsQueue.Rear == __bb_MaxEventsQueue - 1) {
-      __bb_EventsQueue.Rear = -1;
-    }
-    __bb_EventsQueue.Array[++__bb_EventsQueue.Rear] = Event;
-    ++__bb_EventsQueue.EventCount;
-  }
-}
-
 // win32
 static LRESULT CALLBACK __bb_Win32HandleEvents(HWND Handle, UINT Message, WPARAM WParam, LPARAM LParam) {
   LRESULT Result = 0;
@@ -618,35 +635,105 @@ bb_GetClientMousePosition(bb_window *Window, int *X, int *Y) {
   *Y = Point.y;
 }
 
-// events
-bool
-bb_PullEvent(bb_event *Event) {
-  if (__bb_EventsQueue.EventCount == 0) {
-    return false;
+// time
+// NOTE(Brajan): frequency is fixed at boot, query it once
+static volatile long long __bb_TimerStart = 0;
+static volatile long long __bb_TimerFrequency = 0;
+
+long long
+bb_GetPerformanceCounter() {
+  LARGE_INTEGER Counter;
+  QueryPerformanceCounter(&Counter);
+  return Counter.QuadPart;
+}
+
+long long
+bb_GetPerformanceFrequency() {
+  long long Result = bb_AtomicLoad64(&__bb_TimerFrequency);
+  if (!Result) {
+    LARGE_INTEGER Frequency;
+    QueryPerformanceFrequency(&Frequency);
+    Result = Frequency.QuadPart;
+    bb_AtomicStore64(&__bb_TimerFrequency, Result);
   }
 
-  *Event = __bb_EventsQueue.Array[__bb_EventsQueue.Front++];
+  return Result;
+}
 
-  if (__bb_EventsQueue.Front == __bb_MaxEventsQueue) {
-    __bb_EventsQueue.Front = 0;
+static long long
+__bb_GetTimerElapsed() {
+  long long Now = bb_GetPerformanceCounter();
+  long long Start = bb_AtomicLoad64(&__bb_TimerStart);
+  if (Start == 0) {
+    // NOTE(Brajan): 0 means not started yet (counter is never 0 after boot), first caller sets
+    // the start and everybody else uses it. Now of a thread that lost can be a bit older than Start.
+    Start = bb_AtomicCompareExchange64(&__bb_TimerStart, 0, Now);
+    if (Start == 0)
+      Start = Now;
   }
 
-  __bb_EventsQueue.EventCount--;
-  return true;
+  return (Now > Start) ? Now - Start : 0;
 }
 
-// time
-static DWORD __bb_TimerStart = 0;
-static bool __bb_TimerInitialized = false;
-
 unsigned int
 bb_GetTicks() {
-  if (!__bb_TimerInitialized) {
-    __bb_TimerStart = GetTickCount();
-    __bb_TimerInitialized = true;
+  return (unsigned int)(__bb_GetTimerElapsed() * 1000 / bb_GetPerformanceFrequency());
+}
+
+double
+bb_GetTimeSeconds() {
+  return (double)__bb_GetTimerElapsed() / (double)bb_GetPerformanceFrequency();
+}
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+// NOTE(Brajan): high resolution timers (windows 10 1803+) wake up within ~0.5ms, older ones only
+// on scheduler ticks (15.6ms by default), so they get much longer spin
+struct __bb_wait_timer {
+  HANDLE Handle;
+  double SpinTime;
+
+  ~__bb_wait_timer();
+};
+
+// NOTE(Brajan): every thread that waits creates its own timer, the handle is closed when it exits
+static thread_local __bb_wait_timer __bb_WaitTimer;
+
+__bb_wait_timer::~__bb_wait_timer() {
+  if (Handle) {
+    CloseHandle(Handle);
   }
+}
+
+void
+bb_WaitUntil(double Time) {
+  __bb_wait_timer *Timer = &__bb_WaitTimer;
+  if (!Timer->Handle) {
+    Timer->Handle = CreateWaitableTimerExW(0, 0, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    Timer->SpinTime = 0.001;
+    if (!Timer->Handle) {
+      Timer->Handle = CreateWaitableTimerExW(0, 0, 0, TIMER_ALL_ACCESS);
+      Timer->SpinTime = 0.016;
+    }
+  }
+
+  for (;;) {
+    double SleepTime = Time - bb_GetTimeSeconds() - Timer->SpinTime;
+    if (SleepTime <= 0.0 || !Timer->Handle)
+      break;
 
-  return (GetTickCount() - __bb_TimerStart);
+    // NOTE(Brajan): negative due time is relative, in 100ns units
+    LARGE_INTEGER DueTime;
+    DueTime.QuadPart = -(LONGLONG)(SleepTime * 1e7);
+    if (!SetWaitableTimer(Timer->Handle, &DueTime, 0, 0, 0, FALSE))
+      break;
+    WaitForSingleObject(Timer->Handle, INFINITE);
+  }
+
+  while (bb_GetTimeSeconds() < Time)
+    bb_YieldProcessor();
 }
 
 // opengl context
@@ -688,37 +775,85 @@ bb_OpenGLSwapBuffers(bb_opengl_context *Context) {
 }
 
 // memory
-//#include <stdio.h>
-static bb_mutex __bb_MemoryMutex;
+// NOTE(Brajan): pages for the allocator in bb_platform.h, VirtualAlloc reservations are already
+// aligned to allocation granularity (64KB)
+static void *
+__bb_AllocatePages(size_t Size) {
+  void *Memory = VirtualAlloc(0, Size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+  return Memory;
+}
 
-void *
-bb_AllocateMemory(int Size) {
-  if (__bb_MemoryMutex.MutexHandle == 0) {
-    bb_CreateMutex(&__bb_MemoryMutex);
+static void
+__bb_FreePages(void *Memory, size_t Size) {
+  VirtualFree(Memory, 0, MEM_RELEASE);
+}
+
+// virtual memory
+// NOTE(Brajan): large pages need SeLockMemoryPrivilege, we try to enable it once. Large pages can't
+// be reserved without committing, so such memory is committed whole right away.
+static int __bb_LargePagesState = 0; // 0 - not checked, 1 - available, -1 - not available
+
+static bool
+__bb_EnableLargePages() {
+  if (__bb_LargePagesState == 0) {
+    __bb_LargePagesState = -1;
+
+    HANDLE Token;
+    if (OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &Token)) {
+      TOKEN_PRIVILEGES Privileges = {};
+      Privileges.PrivilegeCount = 1;
+      Privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+      if (LookupPrivilegeValueA(NULL, "SeLockMemoryPrivilege", &Privileges.Privileges[0].Luid) &&
+          AdjustTokenPrivileges(Token, FALSE, &Privileges, 0, NULL, NULL) &&
+          GetLastError() == ERROR_SUCCESS && GetLargePageMinimum() != 0) {
+        __bb_LargePagesState = 1;
+      }
+      CloseHandle(Token);
+    }
   }
 
-  void *Mem = 0;
+  return __bb_LargePagesState == 1;
+}
 
-  bb_Lock(&__bb_MemoryMutex);
-  Mem = VirtualAlloc(0, Size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
-  //Mem = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, Size);
-  bb_Unlock(&__bb_MemoryMutex);
+void *
+bb_ReserveMemory(size_t Size, int Flags) {
+  if ((Flags & bb_MemoryLargePages) && __bb_EnableLargePages()) {
+    size_t LargePageSize = GetLargePageMinimum();
+    size_t LargeSize = (Size + LargePageSize - 1) & ~(LargePageSize - 1);
+    void *Memory = VirtualAlloc(0, LargeSize, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+    if (Memory)
+      return Memory;
+  }
+
+  return VirtualAlloc(0, Size, MEM_RESERVE, PAGE_NOACCESS);
+}
 
-  bb_Assert(Mem != 0);
+bool
+bb_CommitMemory(void *Memory, size_t Size) {
+  return VirtualAlloc(Memory, Size, MEM_COMMIT, PAGE_READWRITE) != 0;
+}
 
-  return Mem;
-  //return HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, Size);
-  //return malloc(Size);
-  //return VirtualAlloc(0, Size, MEM_COMMIT, PAGE_READWRITE);
+void
+bb_DecommitMemory(void *Memory, size_t Size) {
+  VirtualFree(Memory, Size, MEM_DECOMMIT);
 }
 
 void
-bb_FreeMemory(void *Memory) {
-  //free(Memory);
-  bb_Lock(&__bb_MemoryMutex);
+bb_ReleaseMemory(void *Memory, size_t Size) {
   VirtualFree(Memory, 0, MEM_RELEASE);
-  //HeapFree(GetProcessHeap(), 0, Memory);
-  bb_Unlock(&__bb_MemoryMutex);
+}
+
+size_t
+bb_GetPageSize() {
+  SYSTEM_INFO SystemInfo;
+  GetSystemInfo(&SystemInfo);
+  return SystemInfo.dwPageSize;
+}
+
+size_t
+bb_GetLargePageSize() {
+  size_t Result = GetLargePageMinimum();
+  return Result ? Result : 2 * 1024 * 1024;
 }
 
 // threads
@@ -749,124 +884,51 @@ bb_DestroyThread(bb_thread *Thread) {
     CloseHandle(Thread->ThreadHandle);
 }
 
-// mutex
-int
-bb_CreateMutex(bb_mutex *Mutex) {
-  Mutex->MutexHandle = CreateMutex(NULL, FALSE, NULL);
-  return 0;
-}
-
 void
-bb_DestroyMutex(bb_mutex *Mutex) {
-  CloseHandle(Mutex->MutexHandle);
+bb_JoinThread(bb_thread *Thread) {
+  if (Thread->ThreadHandle)
+    WaitForSingleObject(Thread->ThreadHandle, INFINITE);
 }
 
-void
-bb_Lock(bb_mutex *Mutex) {
-  WaitForSingleObject(Mutex->MutexHandle, INFINITE);
+unsigned int
+bb_GetCurrentThreadId() {
+  return (unsigned int)GetCurrentThreadId();
 }
 
+// waiting on address
 void
-bb_Unlock(bb_mutex *Mutex) {
-  ReleaseMutex(Mutex->MutexHandle);
+bb_WaitOnAddress(volatile int *Address, int Expected) {
+  WaitOnAddress(Address, &Expected, sizeof(int), INFINITE);
 }
 
-bool
-bb_TryLock(bb_mutex *Mutex) {
-  return WaitForSingleObject(Mutex->MutexHandle, 0) == WAIT_OBJECT_0;
+void
+bb_WakeAddressSingle(volatile int *Address) {
+  WakeByAddressSingle((PVOID)Address);
 }
 
-// thread pool
-struct __bb_worker_task {
-  void(*Function)(void *);
-  void *Data;
-};
-
-static bool
-__bb_GetNextTask(bb_thread_pool *ThreadPool, __bb_worker_task *Task) {
-  bb_Lock(&ThreadPool->Mutex);
-
-  if (ThreadPool->NumTasks <= 0) {
-    bb_Unlock(&ThreadPool->Mutex);
-    return false;
-  }
-
-  *Task = ((__bb_worker_task *)ThreadPool->Tasks)[--ThreadPool->NumTasks];
-  bb_Unlock(&ThreadPool->Mutex);
-  return true;
+void
+bb_WakeAddressAll(volatile int *Address) {
+  WakeByAddressAll((PVOID)Address);
 }
 
-static void
-__bb_ThreadPoolWorker(void *Data) {
-  bb_thread_pool *ThreadPool = (bb_thread_pool *)Data;
-  __bb_worker_task Task;
-  for (;;) {
-    if (ThreadPool->StopFlag)
-      return;
-
-    if (__bb_GetNextTask(ThreadPool, &Task)) {
-      Task.Function(Task.Data);
-    }
-
-    bb_Sleep(1);
-  }
+// files
+bool
+bb_CreateFile(bb_file *File, const char *Path) {
+  File->Handle = CreateFileA(Path, GENERIC_WRITE, 0, 0, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, 0);
+  return File->Handle != INVALID_HANDLE_VALUE;
 }
 
-int
-bb_CreateThreadPool(bb_thread_pool *ThreadPool, int NumWorkers, int MaxTasks) {
-  ThreadPool->Workers = (bb_thread *)bb_AllocateMemory(sizeof(bb_thread) * NumWorkers);
-  ThreadPool->NumWorkers = NumWorkers;
-
-  ThreadPool->Tasks = (__bb_worker_task *)bb_AllocateMemory(sizeof(__bb_worker_task) * MaxTasks);
-  ThreadPool->NumTasks = 0;
-  ThreadPool->TasksCapacity = MaxTasks;
-  bb_ZeroMemory(ThreadPool->Tasks, sizeof(__bb_worker_task) * MaxTasks);
-
-  bb_CreateMutex(&ThreadPool->Mutex);
-  ThreadPool->StopFlag = false;
-
-  // set up workers
-  for (int Index = 0; Index < NumWorkers; ++Index) {
-    bb_CreateThread(&ThreadPool->Workers[Index], __bb_ThreadPoolWorker, ThreadPool);
-  }
-
-  return 0;
+bool
+bb_WriteFile(bb_file *File, const void *Data, int Size) {
+  DWORD Written;
+  return WriteFile(File->Handle, Data, (DWORD)Size, &Written, 0) && Written == (DWORD)Size;
 }
 
 void
-bb_DestroyThreadPool(bb_thread_pool *ThreadPool) {
-  if (ThreadPool == 0)
-    return;
-  for (int Index = 0; Index < ThreadPool->NumWorkers; ++Index) {
-    bb_DestroyThread(&ThreadPool->Workers[Index]);
-  }
-
-  bb_DestroyMutex(&ThreadPool->Mutex);
-
-  bb_FreeMemory(ThreadPool->Tasks);
-  bb_FreeMemory(ThreadPool->Workers);
-}
-
-void 
-bb_StopThreadPool(bb_thread_pool *ThreadPool) {
-  ThreadPool->StopFlag = true;
-}
-
-int
-bb_PushTaskToThreadPool(bb_thread_pool *ThreadPool, void(*Function)(void *), void *Data) {
-  bb_Lock(&ThreadPool->Mutex);
-  if (ThreadPool->NumTasks >= ThreadPool->TasksCapacity) {
-    bb_Unlock(&ThreadPool->Mutex);
-    return 1;
-  }
-
-  __bb_worker_task Task;
-  Task.Function = Function;
-  Task.Data = Data;
-  ((__bb_worker_task *)ThreadPool->Tasks)[ThreadPool->NumTasks++] = Task;
-
-  bb_Unlock(&ThreadPool->Mutex);
-  return 0;
+bb_CloseFile(bb_file *File) {
+  if (File->Handle != INVALID_HANDLE_VALUE)
+    CloseHandle(File->Handle);
+  File->Handle = INVALID_HANDLE_VALUE;
 }
 
 // system
@@ -0,0 +1,150 @@
+// bb_AllocateMemory and bb_FreeMemory against malloc and against asking the OS for pages on every
+// call (what bb_AllocateMemory used to do), nanoseconds per call, and alloc/free pairs per second
+// with 1 to 8 threads allocating at the same time
+// build: g++ -O2 -I.. allocator.cpp -o allocator -lpthread
+#define BB_TOOL_IMPLEMENTATION
+#define BB_PLATFORM_IMPLEMENTATION
+#define BB_PLATFORM_NO_MAIN
+// NOTE(Brajan): all blocks are freed and allocated again, keep their spans so the timed round
+// measures the allocator on warm memory and not the OS
+#define BB_PLATFORM_MAX_EMPTY_SPANS 1000000
+#include "bb_platform.h"
+#include "bench.h"
+#include <stdlib.h>
+
+#define NumBlocks 20000
+#define NumChurns 200000
+#define NumThreadPairs 2000000
+
+enum {
+  AllocatorBB,
+  AllocatorMalloc,
+  AllocatorPages
+};
+
+static void *Blocks[NumBlocks];
+static void *volatile Sink;
+
+static void *
+Allocate(int Allocator, int Size) {
+  switch (Allocator) {
+  case AllocatorBB:
+    return bb_AllocateMemory(Size);
+  case AllocatorMalloc:
+    return malloc((size_t)Size);
+  default:
+    return __bb_AllocatePages((size_t)(Size + 4095) & ~(size_t)4095);
+  }
+}
+
+static void
+Free(int Allocator, void *Memory, int Size) {
+  switch (Allocator) {
+  case AllocatorBB:
+    bb_FreeMemory(Memory);
+    break;
+  case AllocatorMalloc:
+    free(Memory);
+    break;
+  default:
+    __bb_FreePages(Memory, (size_t)(Size + 4095) & ~(size_t)4095);
+    break;
+  }
+}
+
+// NOTE(Brajan): allocates NumBlocks blocks and frees them, then churns one alloc/free pair. First
+// round is not timed, otherwise page faults on fresh memory hide the allocator.
+static void
+Measure(int Allocator, int Size, double *AllocateTime, double *FreeTime, double *PairTime) {
+  for (int Index = 0; Index < NumBlocks; ++Index)
+    Blocks[Index] = Allocate(Allocator, Size);
+  for (int Index = 0; Index < NumBlocks; ++Index)
+    Free(Allocator, Blocks[Index], Size);
+
+  double Start = Now();
+  for (int Index = 0; Index < NumBlocks; ++Index) {
+    Blocks[Index] = Allocate(Allocator, Size);
+    ((char *)Blocks[Index])[0] = 1;
+  }
+  double Middle = Now();
+  for (int Index = 0; Index < NumBlocks; ++Index)
+    Free(Allocator, Blocks[Index], Size);
+  double End = Now();
+  *AllocateTime = (Middle - Start) * 1e9 / NumBlocks;
+  *FreeTime = (End - Middle) * 1e9 / NumBlocks;
+
+  // NOTE(Brajan): OS pages are too slow to churn as often
+  int NumPairs = Allocator == AllocatorPages ? NumChurns / 20 : NumChurns;
+  Start = Now();
+  for (int Index = 0; Index < NumPairs; ++Index) {
+    char *Memory = (char *)Allocate(Allocator, Size);
+    Memory[0] = (char)Index;
+    Sink = Memory;
+    Free(Allocator, Sink, Size);
+  }
+  *PairTime = (Now() - Start) * 1e9 / NumPairs;
+}
+
+static int ThreadAllocator;
+static int NumThreads;
+
+// NOTE(Brajan): every thread keeps a window of live blocks of random small sizes and replaces a random one
+static void
+ThreadWorker(void *Data) {
+  unsigned int State = 2654435761u * (unsigned int)((long long)Data + 1);
+  void *Window[64] = {};
+  int Sizes[64] = {};
+
+  for (int Index = 0; Index < NumThreadPairs / NumThreads; ++Index) {
+    unsigned int Value = Random(&State);
+    int Slot = (int)(Value % 64);
+    if (Window[Slot])
+      Free(ThreadAllocator, Window[Slot], Sizes[Slot]);
+    Sizes[Slot] = 16 + (int)((Value >> 8) % 512);
+    Window[Slot] = Allocate(ThreadAllocator, Sizes[Slot]);
+  }
+
+  for (int Slot = 0; Slot < 64; ++Slot) {
+    if (Window[Slot])
+      Free(ThreadAllocator, Window[Slot], Sizes[Slot]);
+  }
+}
+
+static double
+MeasureThreads(int Allocator, int Threads) {
+  ThreadAllocator = Allocator;
+  NumThreads = Threads;
+
+  bb_thread Workers[8];
+  double Start = Now();
+  for (int Index = 0; Index < NumThreads; ++Index)
+    bb_CreateThread(&Workers[Index], ThreadWorker, (void *)(long long)Index);
+  for (int Index = 0; Index < NumThreads; ++Index) {
+    bb_JoinThread(&Workers[Index]);
+    bb_DestroyThread(&Workers[Index]);
+  }
+  double End = Now();
+
+  return (double)(NumThreadPairs / NumThreads * NumThreads) / (End - Start);
+}
+
+int
+main() {
+  static const int Sizes[] = { 16, 32, 256, 1000, 4096, 16384 };
+  static const char *Names[] = { "bb", "malloc", "os pages" };
+
+  printf("%-6s %-9s %10s %10s %10s (ns per call)\n", "size", "", "allocate", "free", "pair");
+  for (int SizeIndex = 0; SizeIndex < (int)bb_ArrayCount(Sizes); ++SizeIndex) {
+    for (int Allocator = AllocatorBB; Allocator <= AllocatorPages; ++Allocator) {
+      double AllocateTime, FreeTime, PairTime;
+      Measure(Allocator, Sizes[SizeIndex], &AllocateTime, &FreeTime, &PairTime);
+      printf("%-6d %-9s %10.1f %10.1f %10.1f\n", Sizes[SizeIndex], Names[Allocator], AllocateTime, FreeTime, PairTime);
+    }
+  }
+
+  printf("\n%-8s %12s %12s (alloc/free pairs per second, 16-528 bytes)\n", "threads", "bb", "malloc");
+  for (int Threads = 1; Threads <= 8; Threads *= 2)
+    printf("%-8d %12.0f %12.0f\n", Threads, MeasureThreads(AllocatorBB, Threads), MeasureThreads(AllocatorMalloc, Threads));
+
+  return 0;
+}
@@ -0,0 +1,18 @@
+// shared by the benchmarks, include after bb_platform.h: timing and xorshift random numbers
+#include <stdio.h>
+#include <chrono>
+
+// seconds on a monotonic clock
+inline double
+Now() {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// xorshift, threads pass their own State
+inline unsigned int
+Random(unsigned int *State) {
+  *State ^= *State << 13;
+  *State ^= *State >> 17;
+  *State ^= *State << 5;
+  return *State;
+}
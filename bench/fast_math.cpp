@@ -0,0 +1,65 @@
+// bb_InverseSqrt, bb_Sin and bb_Cos against libm, nanoseconds per call over an array
+// build: g++ -O2 -DBB_MATH_FAST -I.. fast_math.cpp -o fast_math -lpthread (and without BB_MATH_FAST)
+#define BB_TOOL_IMPLEMENTATION
+#define BB_PLATFORM_IMPLEMENTATION
+#define BB_PLATFORM_NO_MAIN
+#include "bb_platform.h"
+#include "bench.h"
+
+#define Count 4096
+#define Repeats 2000
+
+enum {
+  OperationInverseSqrt,
+  OperationSin,
+  OperationCos
+};
+
+static volatile float Sink;
+
+static double
+Measure(int Operation, bool UseLibm, const float *Values, float *Result) {
+  double Start = Now();
+  for (int Repeat = 0; Repeat < Repeats; ++Repeat) {
+    for (int Index = 0; Index < Count; ++Index) {
+      float Value = Values[Index];
+      switch (Operation) {
+      case OperationInverseSqrt:
+        Result[Index] = UseLibm ? 1.0f / sqrtf(Value) : bb_InverseSqrt(Value);
+        break;
+      case OperationSin:
+        Result[Index] = UseLibm ? sinf(Value) : bb_Sin(Value);
+        break;
+      case OperationCos:
+        Result[Index] = UseLibm ? cosf(Value) : bb_Cos(Value);
+        break;
+      }
+    }
+    Sink = Result[Repeat % Count];
+  }
+  double Seconds = Now() - Start;
+
+  return Seconds * 1e9 / ((double)Count * Repeats);
+}
+
+int
+main() {
+  static float Values[Count];
+  static float Result[Count];
+  for (int Index = 0; Index < Count; ++Index)
+    Values[Index] = 0.01f + (float)Index * 0.37f;
+
+  static const char *Names[] = { "inverse sqrt", "sin", "cos" };
+#ifdef BB_MATH_FAST
+  printf("%-13s %10s %10s (BB_MATH_FAST, ns per call)\n", "", "bb", "libm");
+#else
+  printf("%-13s %10s %10s (ns per call)\n", "", "bb", "libm");
+#endif
+  for (int Operation = OperationInverseSqrt; Operation <= OperationCos; ++Operation) {
+    double Ours = Measure(Operation, false, Values, Result);
+    double Libm = Measure(Operation, true, Values, Result);
+    printf("%-13s %10.3f %10.3f\n", Names[Operation], Ours, Libm);
+  }
+
+  return 0;
+}
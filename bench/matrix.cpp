@@ -0,0 +1,140 @@
+// bb_mat4 multiply, inverses and batch transforms against plain scalar code, nanoseconds per operation
+// build: g++ -O2 -I.. matrix.cpp -o matrix -lpthread
+#define BB_TOOL_IMPLEMENTATION
+#define BB_PLATFORM_IMPLEMENTATION
+#define BB_PLATFORM_NO_MAIN
+#include "bb_platform.h"
+#include "bench.h"
+
+#define NumMatrices 1024
+#define NumPoints 4096
+#define Repeats 1000
+
+static volatile float Sink;
+
+static bb_mat4
+MultiplyScalar(const bb_mat4& A, const bb_mat4& B) {
+  bb_mat4 Result;
+  for (int Row = 0; Row < 4; ++Row) {
+    for (int Column = 0; Column < 4; ++Column)
+      Result[Row][Column] = A[Row][0] * B[0][Column] + A[Row][1] * B[1][Column] + A[Row][2] * B[2][Column] + A[Row][3] * B[3][Column];
+  }
+  return Result;
+}
+
+// NOTE(Brajan): textbook Gauss-Jordan with partial pivoting
+static bb_mat4
+InverseScalar(const bb_mat4& Matrix) {
+  bb_mat4 Left = Matrix;
+  bb_mat4 Result;
+  for (int Column = 0; Column < 4; ++Column) {
+    int Pivot = Column;
+    for (int Row = Column + 1; Row < 4; ++Row) {
+      if (fabsf(Left[Row][Column]) > fabsf(Left[Pivot][Column]))
+        Pivot = Row;
+    }
+    for (int Index = 0; Index < 4; ++Index) {
+      float Value = Left[Column][Index];
+      Left[Column][Index] = Left[Pivot][Index];
+      Left[Pivot][Index] = Value;
+      Value = Result[Column][Index];
+      Result[Column][Index] = Result[Pivot][Index];
+      Result[Pivot][Index] = Value;
+    }
+
+    float Scale = 1.0f / Left[Column][Column];
+    for (int Index = 0; Index < 4; ++Index) {
+      Left[Column][Index] *= Scale;
+      Result[Column][Index] *= Scale;
+    }
+    for (int Row = 0; Row < 4; ++Row) {
+      if (Row == Column)
+        continue;
+      float Factor = Left[Row][Column];
+      for (int Index = 0; Index < 4; ++Index) {
+        Left[Row][Index] -= Factor * Left[Column][Index];
+        Result[Row][Index] -= Factor * Result[Column][Index];
+      }
+    }
+  }
+  return Result;
+}
+
+int
+main() {
+  static bb_mat4 Matrices[NumMatrices];
+  static bb_mat4 Products[NumMatrices];
+  static bb_vec3 Points[NumPoints];
+  static bb_vec3 Result[NumPoints];
+
+  for (int Index = 0; Index < NumMatrices; ++Index)
+    Matrices[Index] = bb_Translate((float)Index, 1.0f, 2.0f) * bb_Rotate(bb_InitQuaternion((float)Index, bb_vec3(0, 1, 0)));
+  for (int Index = 0; Index < NumPoints; ++Index)
+    Points[Index] = bb_vec3((float)Index, (float)(Index % 13), 1.0f);
+
+  printf("%-19s %10s %10s (ns per matrix or point)\n", "", "bb", "scalar");
+
+  // NOTE(Brajan): chain of multiplies, like walking a transform hierarchy
+  double Start = Now();
+  for (int Repeat = 0; Repeat < Repeats; ++Repeat) {
+    for (int Index = 1; Index < NumMatrices; ++Index)
+      Products[Index] = Products[Index - 1] * Matrices[Index];
+    Sink = Products[NumMatrices - 1][0][3];
+  }
+  double Ours = Now() - Start;
+
+  Start = Now();
+  for (int Repeat = 0; Repeat < Repeats; ++Repeat) {
+    for (int Index = 1; Index < NumMatrices; ++Index)
+      Products[Index] = MultiplyScalar(Products[Index - 1], Matrices[Index]);
+    Sink = Products[NumMatrices - 1][0][3];
+  }
+  double Scalar = Now() - Start;
+  double Multiplies = (double)Repeats * (NumMatrices - 1);
+  printf("%-19s %10.3f %10.3f\n", "multiply", Ours * 1e9 / Multiplies, Scalar * 1e9 / Multiplies);
+
+  for (int Affine = 0; Affine < 2; ++Affine) {
+    Start = Now();
+    for (int Repeat = 0; Repeat < Repeats; ++Repeat) {
+      for (int Index = 0; Index < NumMatrices; ++Index)
+        Products[Index] = Affine ? bb_AffineInverse(Matrices[Index]) : bb_Inverse(Matrices[Index]);
+      Sink = Products[Repeat % NumMatrices][0][3];
+    }
+    Ours = Now() - Start;
+
+    Start = Now();
+    for (int Repeat = 0; Repeat < Repeats; ++Repeat) {
+      for (int Index = 0; Index < NumMatrices; ++Index)
+        Products[Index] = InverseScalar(Matrices[Index]);
+      Sink = Products[Repeat % NumMatrices][0][3];
+    }
+    Scalar = Now() - Start;
+    double Inverses = (double)Repeats * NumMatrices;
+    printf("%-19s %10.3f %10.3f\n", Affine ? "affine inverse" : "inverse", Ours * 1e9 / Inverses, Scalar * 1e9 / Inverses);
+  }
+
+  for (int Direction = 0; Direction < 2; ++Direction) {
+    const bb_mat4& Matrix = Matrices[7];
+    Start = Now();
+    for (int Repeat = 0; Repeat < Repeats; ++Repeat) {
+      if (Direction)
+        bb_TransformDirections(Matrix, Points, Result, NumPoints);
+      else
+        bb_TransformPoints(Matrix, Points, Result, NumPoints);
+      Sink = Result[Repeat % NumPoints].X;
+    }
+    Ours = Now() - Start;
+
+    Start = Now();
+    for (int Repeat = 0; Repeat < Repeats; ++Repeat) {
+      for (int Index = 0; Index < NumPoints; ++Index)
+        Result[Index] = Direction ? bb_TransformDirection(Matrix, Points[Index]) : bb_TransformPoint(Matrix, Points[Index]);
+      Sink = Result[Repeat % NumPoints].X;
+    }
+    Scalar = Now() - Start;
+    double Transforms = (double)Repeats * NumPoints;
+    printf("%-19s %10.3f %10.3f\n", Direction ? "transform direction" : "transform point", Ours * 1e9 / Transforms, Scalar * 1e9 / Transforms);
+  }
+
+  return 0;
+}
@@ -0,0 +1,79 @@
+// bb_ZeroMemory, bb_CopyMemory and bb_MoveMemory against libc, GB/s for a few sizes
+// build: g++ -O2 -I.. memory.cpp -o memory -lpthread
+#define BB_TOOL_IMPLEMENTATION
+#define BB_PLATFORM_IMPLEMENTATION
+#define BB_PLATFORM_NO_MAIN
+#include "bb_platform.h"
+#include "bench.h"
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+  OperationZero,
+  OperationCopy,
+  OperationMove
+};
+
+static volatile unsigned char Sink;
+
+// NOTE(Brajan): repeats the operation for ~0.1s worth of bytes, returns GB/s
+static double
+Measure(int Operation, bool UseLibc, unsigned char *Source, unsigned char *Destination, size_t Size) {
+  long long Repeats = (long long)(bb_Megabytes(512) / Size);
+  if (Repeats < 4)
+    Repeats = 4;
+
+  double Start = Now();
+  for (long long Repeat = 0; Repeat < Repeats; ++Repeat) {
+    switch (Operation) {
+    case OperationZero:
+      if (UseLibc)
+        memset(Destination, 0, Size);
+      else
+        bb_ZeroMemory(Destination, Size);
+      break;
+    case OperationCopy:
+      if (UseLibc)
+        memcpy(Destination, Source, Size);
+      else
+        bb_CopyMemory(Source, Destination, Size);
+      break;
+    case OperationMove:
+      // NOTE(Brajan): overlapping by one cache line, backwards
+      if (UseLibc)
+        memmove(Source + 64, Source, Size);
+      else
+        bb_MoveMemory(Source, Source + 64, Size);
+      break;
+    }
+    Sink = Destination[Repeat % Size];
+  }
+  double Seconds = Now() - Start;
+  return (double)Size * (double)Repeats / Seconds / 1e9;
+}
+
+int
+main() {
+  static const size_t Sizes[] = { 64, 256, bb_Kilobytes(4), bb_Kilobytes(64), bb_Megabytes(1), bb_Megabytes(32) };
+  static const char *Names[] = { "zero", "copy", "move" };
+
+  size_t BufferSize = bb_Megabytes(32) + 128;
+  unsigned char *Source = (unsigned char *)malloc(BufferSize);
+  unsigned char *Destination = (unsigned char *)malloc(BufferSize);
+  memset(Source, 1, BufferSize);
+  memset(Destination, 2, BufferSize);
+
+  printf("%-6s %10s %10s %10s\n", "", "size", "bb GB/s", "libc GB/s");
+  for (int Operation = OperationZero; Operation <= OperationMove; ++Operation) {
+    for (int SizeIndex = 0; SizeIndex < (int)bb_ArrayCount(Sizes); ++SizeIndex) {
+      size_t Size = Sizes[SizeIndex];
+      double Ours = Measure(Operation, false, Source, Destination, Size);
+      double Libc = Measure(Operation, true, Source, Destination, Size);
+      printf("%-6s %10zu %10.2f %10.2f\n", Names[Operation], Size, Ours, Libc);
+    }
+  }
+
+  free(Source);
+  free(Destination);
+  return 0;
+}
@@ -0,0 +1,108 @@
+// bb_mutex and bb_rw_mutex against the OS mutex (kernel mutex on windows like the old bb_mutex,
+// pthread mutex elsewhere), nanoseconds per lock and unlock with 1 to 8 threads
+// build: g++ -O2 -I.. mutex.cpp -o mutex -lpthread
+#define BB_TOOL_IMPLEMENTATION
+#define BB_PLATFORM_IMPLEMENTATION
+#define BB_PLATFORM_NO_MAIN
+#include "bb_platform.h"
+#include "bench.h"
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+#define NumIterations 1000000
+
+enum {
+  LockMutex,
+  LockRWMutex,
+  LockOS
+};
+
+static bb_mutex Mutex;
+static bb_rw_mutex RWMutex;
+#ifdef _WIN32
+static HANDLE OSMutex;
+#else
+static pthread_mutex_t OSMutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+static int Kind;
+static int NumThreads;
+static volatile long long Counter;
+
+static void
+Worker(void *) {
+  // NOTE(Brajan): same total work split across threads, short critical section
+  for (int Iteration = 0; Iteration < NumIterations / NumThreads; ++Iteration) {
+    switch (Kind) {
+    case LockMutex:
+      bb_Lock(&Mutex);
+      Counter = Counter + 1;
+      bb_Unlock(&Mutex);
+      break;
+    case LockRWMutex:
+      // NOTE(Brajan): one write every 16 reads
+      if ((Iteration & 15) == 0) {
+        bb_LockWrite(&RWMutex);
+        Counter = Counter + 1;
+        bb_UnlockWrite(&RWMutex);
+      } else {
+        bb_LockRead(&RWMutex);
+        (void)Counter;
+        bb_UnlockRead(&RWMutex);
+      }
+      break;
+    case LockOS:
+#ifdef _WIN32
+      WaitForSingleObject(OSMutex, INFINITE);
+      Counter = Counter + 1;
+      ReleaseMutex(OSMutex);
+#else
+      pthread_mutex_lock(&OSMutex);
+      Counter = Counter + 1;
+      pthread_mutex_unlock(&OSMutex);
+#endif
+      break;
+    }
+  }
+}
+
+static double
+Measure(int LockKind, int Threads) {
+  Kind = LockKind;
+  NumThreads = Threads;
+
+  bb_thread Workers[8];
+  double Start = Now();
+  for (int Index = 0; Index < NumThreads; ++Index)
+    bb_CreateThread(&Workers[Index], Worker, 0);
+  for (int Index = 0; Index < NumThreads; ++Index) {
+    bb_JoinThread(&Workers[Index]);
+    bb_DestroyThread(&Workers[Index]);
+  }
+  return (Now() - Start) * 1e9 / (double)NumIterations;
+}
+
+int
+main() {
+  bb_CreateMutex(&Mutex);
+  bb_CreateRWMutex(&RWMutex);
+#ifdef _WIN32
+  OSMutex = CreateMutexA(0, FALSE, 0);
+#endif
+
+  printf("%-8s %10s %10s %10s (ns per lock and unlock)\n", "threads", "bb_mutex", "rw 1:16", "os mutex");
+  for (int Threads = 1; Threads <= 8; Threads *= 2) {
+    double Ours = Measure(LockMutex, Threads);
+    double ReadWrite = Measure(LockRWMutex, Threads);
+    double OS = Measure(LockOS, Threads);
+    printf("%-8d %10.2f %10.2f %10.2f\n", Threads, Ours, ReadWrite, OS);
+  }
+
+#ifdef _WIN32
+  CloseHandle(OSMutex);
+#endif
+  bb_DestroyRWMutex(&RWMutex);
+  bb_DestroyMutex(&Mutex);
+  return 0;
+}
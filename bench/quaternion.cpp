@@ -0,0 +1,98 @@
+// batch quaternion kernels against scalar loops, nanoseconds per element
+// build: g++ -O2 -I.. quaternion.cpp -o quaternion -lpthread
+#define BB_TOOL_IMPLEMENTATION
+#define BB_PLATFORM_IMPLEMENTATION
+#define BB_PLATFORM_NO_MAIN
+#include "bb_platform.h"
+#include "bench.h"
+#include <stdlib.h>
+
+#define Count 4096
+#define Repeats 1000
+
+enum {
+  OperationRotate,
+  OperationNormalize,
+  OperationNlerp,
+  OperationSlerp
+};
+
+static volatile float Sink;
+
+static double
+Measure(int Operation, bool Batch, bb_quaternion_soa A, bb_quaternion_soa B, bb_quaternion_soa Result,
+        bb_vec3_soa Vectors, bb_vec3_soa Rotated) {
+  double Start = Now();
+  for (int Repeat = 0; Repeat < Repeats; ++Repeat) {
+    float T = (float)(Repeat % 100) / 100.0f;
+    switch (Operation) {
+    case OperationRotate:
+      if (Batch) {
+        bb_RotateN(A, Vectors, Rotated, Count);
+      } else {
+        for (int Index = 0; Index < Count; ++Index)
+          bb_SetVec3(Rotated, Index, bb_Rotate(bb_GetVec3(Vectors, Index), bb_GetQuaternion(A, Index)));
+      }
+      break;
+    case OperationNormalize:
+      if (Batch) {
+        bb_NormalizeN(A, Result, Count);
+      } else {
+        for (int Index = 0; Index < Count; ++Index)
+          bb_SetQuaternion(Result, Index, bb_Normalized(bb_GetQuaternion(A, Index)));
+      }
+      break;
+    case OperationNlerp:
+      if (Batch) {
+        bb_NlerpN(A, B, T, Result, Count);
+      } else {
+        for (int Index = 0; Index < Count; ++Index)
+          bb_SetQuaternion(Result, Index, bb_Nlerp(bb_GetQuaternion(A, Index), bb_GetQuaternion(B, Index), T));
+      }
+      break;
+    case OperationSlerp:
+      if (Batch) {
+        bb_SlerpN(A, B, T, Result, Count);
+      } else {
+        for (int Index = 0; Index < Count; ++Index)
+          bb_SetQuaternion(Result, Index, bb_Slerp(bb_GetQuaternion(A, Index), bb_GetQuaternion(B, Index), T));
+      }
+      break;
+    }
+    Sink = Result.X[Repeat % Count] + Rotated.X[Repeat % Count];
+  }
+  double Seconds = Now() - Start;
+
+  return Seconds * 1e9 / ((double)Count * Repeats);
+}
+
+int
+main() {
+  size_t ArenaSize = bb_Megabytes(1);
+  bb_memory_arena Arena;
+  bb_InitializeArena(&Arena, ArenaSize, malloc(ArenaSize));
+
+  bb_quaternion_soa A = bb_PushQuaternionSoA(&Arena, Count);
+  bb_quaternion_soa B = bb_PushQuaternionSoA(&Arena, Count);
+  bb_quaternion_soa Result = bb_PushQuaternionSoA(&Arena, Count);
+  bb_vec3_soa Vectors = bb_PushVec3SoA(&Arena, Count);
+  bb_vec3_soa Rotated = bb_PushVec3SoA(&Arena, Count);
+  for (int Index = 0; Index < Count; ++Index) {
+    bb_SetQuaternion(A, Index, bb_InitQuaternion((float)Index * 0.01f, bb_Normalized(bb_vec3(1, 2, 3))));
+    bb_SetQuaternion(B, Index, bb_InitQuaternion((float)Index * 0.02f + 1.0f, bb_Normalized(bb_vec3(3, 1, 2))));
+    bb_SetQuaternion(Result, Index, bb_quaternion());
+    bb_SetVec3(Vectors, Index, bb_vec3((float)Index, 1.0f, 2.0f));
+    bb_SetVec3(Rotated, Index, bb_vec3());
+  }
+
+  static const char *Names[] = { "rotate", "normalize", "nlerp", "slerp" };
+  printf("%-10s %10s %10s (%d elements, ns per element)\n", "", "batch", "scalar", Count);
+  for (int Operation = OperationRotate; Operation <= OperationSlerp; ++Operation) {
+    double Batch = Measure(Operation, true, A, B, Result, Vectors, Rotated);
+    double Scalar = Measure(Operation, false, A, B, Result, Vectors, Rotated);
+    printf("%-10s %10.3f %10.3f\n", Names[Operation], Batch, Scalar);
+  }
+
+  free(Arena.Base);
+  return 0;
+}
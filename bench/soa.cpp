@@ -0,0 +1,100 @@
+// SoA batch kernels against scalar loops over bb_vec3 arrays, nanoseconds per vector
+// build: g++ -O2 -I.. soa.cpp -o soa -lpthread (and with -DBB_MATH_FAST)
+#define BB_TOOL_IMPLEMENTATION
+#define BB_PLATFORM_IMPLEMENTATION
+#define BB_PLATFORM_NO_MAIN
+#include "bb_platform.h"
+#include "bench.h"
+#include <stdlib.h>
+
+#define Count 4096
+#define Repeats 2000
+
+enum {
+  OperationDot,
+  OperationCross,
+  OperationNormalize,
+  OperationAddScaled
+};
+
+static volatile float Sink;
+
+static double
+Measure(int Operation, bool Batch, bb_vec3_soa A, bb_vec3_soa B, bb_vec3_soa Result, float *Dots,
+        bb_vec3 *ScalarA, bb_vec3 *ScalarB, bb_vec3 *ScalarResult) {
+  double Start = Now();
+  for (int Repeat = 0; Repeat < Repeats; ++Repeat) {
+    switch (Operation) {
+    case OperationDot:
+      if (Batch) {
+        bb_DotN(A, B, Dots, Count);
+      } else {
+        for (int Index = 0; Index < Count; ++Index)
+          Dots[Index] = bb_Dot(ScalarA[Index], ScalarB[Index]);
+      }
+      break;
+    case OperationCross:
+      if (Batch) {
+        bb_CrossN(A, B, Result, Count);
+      } else {
+        for (int Index = 0; Index < Count; ++Index)
+          ScalarResult[Index] = bb_Cross(ScalarA[Index], ScalarB[Index]);
+      }
+      break;
+    case OperationNormalize:
+      if (Batch) {
+        bb_NormalizeN(A, Result, Count);
+      } else {
+        for (int Index = 0; Index < Count; ++Index)
+          ScalarResult[Index] = bb_Normalized(ScalarA[Index]);
+      }
+      break;
+    case OperationAddScaled:
+      if (Batch) {
+        bb_AddScaledN(A, B, 0.5f, Result, Count);
+      } else {
+        for (int Index = 0; Index < Count; ++Index)
+          ScalarResult[Index] = ScalarA[Index] + ScalarB[Index] * 0.5f;
+      }
+      break;
+    }
+    Sink = Dots[Repeat % Count] + Result.X[Repeat % Count] + ScalarResult[Repeat % Count].X;
+  }
+  double Seconds = Now() - Start;
+
+  return Seconds * 1e9 / ((double)Count * Repeats);
+}
+
+int
+main() {
+  size_t ArenaSize = bb_Megabytes(1);
+  bb_memory_arena Arena;
+  bb_InitializeArena(&Arena, ArenaSize, malloc(ArenaSize));
+
+  bb_vec3_soa A = bb_PushVec3SoA(&Arena, Count);
+  bb_vec3_soa B = bb_PushVec3SoA(&Arena, Count);
+  bb_vec3_soa Result = bb_PushVec3SoA(&Arena, Count);
+  float *Dots = bb_PushArray(&Arena, Count, float);
+  bb_vec3 *ScalarA = bb_PushArray(&Arena, Count, bb_vec3);
+  bb_vec3 *ScalarB = bb_PushArray(&Arena, Count, bb_vec3);
+  bb_vec3 *ScalarResult = bb_PushArray(&Arena, Count, bb_vec3);
+  for (int Index = 0; Index < Count; ++Index) {
+    ScalarA[Index] = bb_vec3((float)(Index % 7) + 1.0f, (float)(Index % 5), (float)(Index % 3));
+    ScalarB[Index] = bb_vec3((float)(Index % 2), 1.0f, (float)(Index % 11));
+    ScalarResult[Index] = bb_vec3();
+    bb_SetVec3(A, Index, ScalarA[Index]);
+    bb_SetVec3(B, Index, ScalarB[Index]);
+    bb_SetVec3(Result, Index, bb_vec3());
+  }
+
+  static const char *Names[] = { "dot", "cross", "normalize", "add scaled" };
+  printf("%-11s %12s %12s (%d vectors, ns per vector)\n", "", "batch", "scalar", Count);
+  for (int Operation = OperationDot; Operation <= OperationAddScaled; ++Operation) {
+    double Batch = Measure(Operation, true, A, B, Result, Dots, ScalarA, ScalarB, ScalarResult);
+    double Scalar = Measure(Operation, false, A, B, Result, Dots, ScalarA, ScalarB, ScalarResult);
+    printf("%-11s %12.3f %12.3f\n", Names[Operation], Batch, Scalar);
+  }
+
+  free(Arena.Base);
+  return 0;
+}
@@ -0,0 +1,84 @@
+// bb_StringLength, bb_StringCompare and bb_StringFindChar against libc, GB/s for a few lengths
+// build: g++ -O2 -I.. string.cpp -o string -lpthread
+#define BB_TOOL_IMPLEMENTATION
+#define BB_PLATFORM_IMPLEMENTATION
+#define BB_PLATFORM_NO_MAIN
+#include "bb_platform.h"
+#include "bench.h"
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+  OperationLength,
+  OperationCompare,
+  OperationFindChar,
+  OperationHash
+};
+
+static volatile long long Sink;
+
+// NOTE(Brajan): B is the same string as A, so compare has to go through all of it
+static double
+Measure(int Operation, bool UseLibc, const char *StringA, const char *StringB, size_t Length) {
+  long long Repeats = (long long)(bb_Megabytes(256) / (Length + 1));
+  long long Result = 0;
+
+  // NOTE(Brajan): strings are read through volatile pointers, so calls can't be hoisted out of the loop
+  const char *volatile VolatileA = StringA;
+  const char *volatile VolatileB = StringB;
+
+  double Start = Now();
+  for (long long Repeat = 0; Repeat < Repeats; ++Repeat) {
+    const char *A = VolatileA;
+    const char *B = VolatileB;
+    switch (Operation) {
+    case OperationLength:
+      Result += UseLibc ? (long long)strlen(A) : bb_StringLength(A);
+      break;
+    case OperationCompare:
+      Result += UseLibc ? strcmp(A, B) : bb_StringCompare(A, B);
+      break;
+    case OperationFindChar:
+      Result += UseLibc ? (strchr(A, 'x') != 0) : (bb_StringFindChar(A, 'x') != 0);
+      break;
+    case OperationHash:
+      Result += (long long)bb_StringHash(A);
+      break;
+    }
+  }
+  double Seconds = Now() - Start;
+  Sink = Result;
+
+  return (double)Length * (double)Repeats / Seconds / 1e9;
+}
+
+int
+main() {
+  static const size_t Lengths[] = { 8, 24, 64, 256, 4096, 65536 };
+  static const char *Names[] = { "length", "compare", "find", "hash" };
+
+  char *A = (char *)malloc(65536 + 1);
+  char *B = (char *)malloc(65536 + 1);
+
+  printf("%-8s %8s %10s %10s\n", "", "length", "bb GB/s", "libc GB/s");
+  for (int Operation = OperationLength; Operation <= OperationHash; ++Operation) {
+    for (int LengthIndex = 0; LengthIndex < (int)bb_ArrayCount(Lengths); ++LengthIndex) {
+      size_t Length = Lengths[LengthIndex];
+      memset(A, 'a', Length);
+      A[Length] = 0;
+      memcpy(B, A, Length + 1);
+
+      double Ours = Measure(Operation, false, A, B, Length);
+      if (Operation == OperationHash) {
+        printf("%-8s %8zu %10.2f %10s\n", Names[Operation], Length, Ours, "-");
+      } else {
+        double Libc = Measure(Operation, true, A, B, Length);
+        printf("%-8s %8zu %10.2f %10.2f\n", Names[Operation], Length, Ours, Libc);
+      }
+    }
+  }
+
+  free(A);
+  free(B);
+  return 0;
+}
@@ -0,0 +1,67 @@
+// throughput of the shared bb_thread_pool task queue, tasks per second for 1 to 8 producer threads
+// outside of the pool against 1 to 8 workers
+// build: g++ -O2 -I.. task_queue.cpp -o task_queue -lpthread
+#define BB_TOOL_IMPLEMENTATION
+#define BB_PLATFORM_IMPLEMENTATION
+#define BB_PLATFORM_NO_MAIN
+#include "bb_platform.h"
+#include "bench.h"
+
+#define NumTasks 400000
+
+static bb_thread_pool Pool;
+static int NumProducers;
+static volatile int Count;
+
+static void
+EmptyTask(void *) {
+  bb_AtomicAdd(&Count, 1);
+}
+
+static void
+Producer(void *) {
+  for (int Index = 0; Index < NumTasks / NumProducers; ++Index) {
+    // NOTE(Brajan): queue is bounded, retry while it's full
+    while (bb_PushTaskToThreadPool(&Pool, EmptyTask, 0) != 0)
+      bb_YieldProcessor();
+  }
+}
+
+static double
+Measure(int Workers, int Producers) {
+  NumProducers = Producers;
+  Count = 0;
+  bb_CreateThreadPool(&Pool, Workers, 4096);
+
+  double Start = Now();
+  bb_thread Threads[8];
+  for (int Index = 0; Index < NumProducers; ++Index)
+    bb_CreateThread(&Threads[Index], Producer, 0);
+  for (int Index = 0; Index < NumProducers; ++Index) {
+    bb_JoinThread(&Threads[Index]);
+    bb_DestroyThread(&Threads[Index]);
+  }
+  while (bb_AtomicLoad(&Count) < NumTasks / NumProducers * NumProducers)
+    bb_YieldProcessor();
+  double Seconds = Now() - Start;
+
+  bb_DestroyThreadPool(&Pool);
+  return (double)Count / Seconds;
+}
+
+int
+main() {
+  printf("%-18s", "workers/producers");
+  for (int Producers = 1; Producers <= 8; Producers *= 2)
+    printf(" %12d", Producers);
+  printf(" (tasks per second)\n");
+
+  for (int Workers = 1; Workers <= 8; Workers *= 2) {
+    printf("%-18d", Workers);
+    for (int Producers = 1; Producers <= 8; Producers *= 2)
+      printf(" %12.0f", Measure(Workers, Producers));
+    printf("\n");
+  }
+
+  return 0;
+}
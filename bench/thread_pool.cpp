@@ -0,0 +1,96 @@
+// bb_thread_pool throughput, tasks per second for 1 to 16 workers with tasks pushed from the main
+// thread, pushed from inside tasks, pushed into a task group and waited on, and bb_ParallelFor chunks
+// build: g++ -O2 -I.. thread_pool.cpp -o thread_pool -lpthread
+#define BB_TOOL_IMPLEMENTATION
+#define BB_PLATFORM_IMPLEMENTATION
+#define BB_PLATFORM_NO_MAIN
+#include "bb_platform.h"
+#include "bench.h"
+
+#define NumTasks 200000
+#define NumSpawners 64
+
+static bb_thread_pool Pool;
+static volatile int Count;
+static volatile int Sink;
+
+// NOTE(Brajan): a bit of work so the task isn't only queue traffic
+static void
+WorkTask(void *) {
+  int Value = 0;
+  for (int Index = 0; Index < 200; ++Index)
+    Value += Index * Index;
+  Sink = Value;
+  bb_AtomicAdd(&Count, 1);
+}
+
+static void
+SpawnerTask(void *) {
+  for (int Index = 0; Index < NumTasks / NumSpawners; ++Index) {
+    while (bb_PushTaskToThreadPool(&Pool, WorkTask, 0) != 0)
+      bb_YieldProcessor();
+  }
+}
+
+static void
+WorkRange(int Begin, int End, void *) {
+  for (int Index = Begin; Index < End; ++Index)
+    WorkTask(0);
+}
+
+static void
+WaitForCount(int Expected) {
+  while (bb_AtomicLoad(&Count) < Expected)
+    bb_YieldProcessor();
+}
+
+int
+main() {
+  printf("%-8s %14s %14s %14s %14s (tasks per second)\n", "workers", "external", "nested", "group", "parallel for");
+  for (int NumWorkers = 1; NumWorkers <= 16; NumWorkers *= 2) {
+    bb_CreateThreadPool(&Pool, NumWorkers, 4096);
+
+    Count = 0;
+    double Start = Now();
+    for (int Index = 0; Index < NumTasks; ++Index) {
+      // NOTE(Brajan): shared queue is bounded, retry while it's full
+      while (bb_PushTaskToThreadPool(&Pool, WorkTask, 0) != 0)
+        bb_YieldProcessor();
+    }
+    WaitForCount(NumTasks);
+    double External = Now() - Start;
+
+    Count = 0;
+    Start = Now();
+    for (int Index = 0; Index < NumSpawners; ++Index)
+      bb_PushTaskToThreadPool(&Pool, SpawnerTask, 0);
+    WaitForCount(NumTasks / NumSpawners * NumSpawners);
+    double Nested = Now() - Start;
+
+    // NOTE(Brajan): groups of 1000 tasks, the main thread helps while it waits
+    Count = 0;
+    Start = Now();
+    for (int Round = 0; Round < NumTasks / 1000; ++Round) {
+      bb_task_group Group;
+      bb_InitTaskGroup(&Group);
+      for (int Index = 0; Index < 1000; ++Index) {
+        while (bb_PushTaskToGroup(&Pool, &Group, WorkTask, 0) != 0)
+          bb_YieldProcessor();
+      }
+      bb_WaitTaskGroup(&Pool, &Group);
+    }
+    double Grouped = Now() - Start;
+
+    // one work item per index, chunks of 64
+    Count = 0;
+    Start = Now();
+    for (int Round = 0; Round < 10; ++Round)
+      bb_ParallelFor(&Pool, 0, NumTasks / 10, 64, WorkRange, 0);
+    double ParallelFor = Now() - Start;
+
+    printf("%-8d %14.0f %14.0f %14.0f %14.0f\n", NumWorkers, NumTasks / External, NumTasks / Nested, NumTasks / Grouped, NumTasks / ParallelFor);
+    bb_DestroyThreadPool(&Pool);
+  }
+
+  return 0;
+}
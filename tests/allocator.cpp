@@ -0,0 +1,280 @@
+// tests of bb_AllocateMemory and bb_FreeMemory: size classes, zeroed and aligned blocks, random sizes
+// with patterns that must survive until the block is freed, 1 to 8 threads passing blocks to each
+// other so they get freed on a different thread than the one that allocated them, empty spans
+// going back to the os, and memory used by thread exit destructors after the thread cache is gone
+// build: g++ -O2 -I.. allocator.cpp -o allocator -lpthread
+#define BB_TOOL_IMPLEMENTATION
+#define BB_PLATFORM_IMPLEMENTATION
+#define BB_PLATFORM_NO_MAIN
+#include "bb_platform.h"
+#include "test.h"
+
+// NOTE(Brajan): mostly small blocks, some up to the largest class, a few large spans
+static int
+RandomSize(unsigned int Value) {
+  switch (Value % 16) {
+  case 0:
+    return (int)(Value >> 8) % (bb_Kilobytes(256));
+  case 1:
+  case 2:
+    return (int)(Value >> 8) % (__bb_MaxSmallSize + 1);
+  default:
+    return (int)(Value >> 8) % 257;
+  }
+}
+
+// NOTE(Brajan): pattern depends on block address and size, so overlapping blocks break each other
+static unsigned char
+Pattern(void *Memory, int Size, int Index) {
+  return (unsigned char)(((size_t)Memory >> 4) * 31 + (size_t)Size * 7 + (size_t)Index);
+}
+
+static void
+Fill(void *Memory, int Size) {
+  unsigned char *Bytes = (unsigned char *)Memory;
+  for (int Index = 0; Index < Size; ++Index)
+    Bytes[Index] = Pattern(Memory, Size, Index);
+}
+
+static bool
+Verify(void *Memory, int Size) {
+  unsigned char *Bytes = (unsigned char *)Memory;
+  for (int Index = 0; Index < Size; ++Index) {
+    if (Bytes[Index] != Pattern(Memory, Size, Index))
+      return false;
+  }
+  return true;
+}
+
+static bool
+IsZero(void *Memory, int Size) {
+  unsigned char *Bytes = (unsigned char *)Memory;
+  for (int Index = 0; Index < Size; ++Index) {
+    if (Bytes[Index])
+      return false;
+  }
+  return true;
+}
+
+static void
+TestSizeClasses() {
+  for (int Size = 1; Size <= __bb_MaxSmallSize; ++Size) {
+    int SizeClass = __bb_GetSizeClass((size_t)Size);
+    size_t ClassSize = __bb_GetSizeClassSize(SizeClass);
+    bool Smallest = SizeClass == 0 || __bb_GetSizeClassSize(SizeClass - 1) < (size_t)Size;
+    Check(SizeClass >= 0 && SizeClass < __bb_NumSizeClasses && ClassSize >= (size_t)Size && Smallest,
+          "size %d, class %d of size %zu", Size, SizeClass, ClassSize);
+  }
+  Check(__bb_GetSizeClass(0) == 0, "size 0");
+  Check(__bb_GetSizeClassSize(__bb_NumSizeClasses - 1) == __bb_MaxSmallSize, "largest class %zu", __bb_GetSizeClassSize(__bb_NumSizeClasses - 1));
+}
+
+struct block {
+  void *Memory;
+  int Size;
+};
+
+static void
+TestRandom() {
+  static block Blocks[4096];
+  for (int Index = 0; Index < (int)bb_ArrayCount(Blocks); ++Index)
+    Blocks[Index].Memory = 0;
+
+  for (int Iteration = 0; Iteration < 200000; ++Iteration) {
+    block *Block = &Blocks[Random() % bb_ArrayCount(Blocks)];
+    if (Block->Memory) {
+      Check(Verify(Block->Memory, Block->Size), "%d bytes at %p overwritten", Block->Size, Block->Memory);
+      bb_FreeMemory(Block->Memory);
+      Block->Memory = 0;
+    } else {
+      Block->Size = RandomSize(Random());
+      Block->Memory = bb_AllocateMemory(Block->Size);
+      Check(Block->Memory != 0, "%d bytes", Block->Size);
+      Check(((size_t)Block->Memory & 15) == 0, "%d bytes at %p not aligned", Block->Size, Block->Memory);
+      Check(IsZero(Block->Memory, Block->Size), "%d bytes at %p not zeroed", Block->Size, Block->Memory);
+      Fill(Block->Memory, Block->Size);
+    }
+  }
+
+  for (int Index = 0; Index < (int)bb_ArrayCount(Blocks); ++Index) {
+    if (Blocks[Index].Memory) {
+      Check(Verify(Blocks[Index].Memory, Blocks[Index].Size), "%d bytes overwritten at the end", Blocks[Index].Size);
+      bb_FreeMemory(Blocks[Index].Memory);
+    }
+  }
+
+  bb_FreeMemory(0);
+}
+
+// NOTE(Brajan): blocks handed over between threads, any thread can free them
+static bb_mutex SharedMutex;
+static block SharedBlocks[256];
+static volatile int Broken;
+
+static void
+Worker(void *Data) {
+  unsigned int State = 2654435761u * (unsigned int)((long long)Data + 1);
+  block Blocks[64] = {};
+
+  for (int Iteration = 0; Iteration < 20000; ++Iteration) {
+    unsigned int Value = Random(&State);
+    block *Block = &Blocks[Value % bb_ArrayCount(Blocks)];
+    if (Block->Memory == 0) {
+      Block->Size = RandomSize(Value >> 6);
+      Block->Memory = bb_AllocateMemory(Block->Size);
+      if (!IsZero(Block->Memory, Block->Size))
+        bb_AtomicStore(&Broken, 1);
+      Fill(Block->Memory, Block->Size);
+      continue;
+    }
+
+    // NOTE(Brajan): swap with a shared slot or free it here
+    if (Value & 64) {
+      bb_Lock(&SharedMutex);
+      block *Shared = &SharedBlocks[(Value >> 8) % bb_ArrayCount(SharedBlocks)];
+      block Swap = *Shared;
+      *Shared = *Block;
+      *Block = Swap;
+      bb_Unlock(&SharedMutex);
+    } else {
+      if (!Verify(Block->Memory, Block->Size))
+        bb_AtomicStore(&Broken, 1);
+      bb_FreeMemory(Block->Memory);
+      Block->Memory = 0;
+    }
+  }
+
+  for (int Index = 0; Index < (int)bb_ArrayCount(Blocks); ++Index) {
+    if (Blocks[Index].Memory) {
+      if (!Verify(Blocks[Index].Memory, Blocks[Index].Size))
+        bb_AtomicStore(&Broken, 1);
+      bb_FreeMemory(Blocks[Index].Memory);
+    }
+  }
+}
+
+static void
+TestThreads() {
+  bb_CreateMutex(&SharedMutex);
+  for (int NumThreads = 1; NumThreads <= 8; NumThreads *= 2) {
+    Broken = 0;
+    bb_thread Threads[8];
+    for (int Index = 0; Index < NumThreads; ++Index)
+      bb_CreateThread(&Threads[Index], Worker, (void *)(long long)Index);
+    for (int Index = 0; Index < NumThreads; ++Index) {
+      bb_JoinThread(&Threads[Index]);
+      bb_DestroyThread(&Threads[Index]);
+    }
+
+    for (int Index = 0; Index < (int)bb_ArrayCount(SharedBlocks); ++Index) {
+      block *Block = &SharedBlocks[Index];
+      if (Block->Memory) {
+        if (!Verify(Block->Memory, Block->Size))
+          Broken = 1;
+        bb_FreeMemory(Block->Memory);
+        Block->Memory = 0;
+      }
+    }
+    Check(!Broken, "%d threads, block overwritten or not zeroed", NumThreads);
+  }
+  bb_DestroyMutex(&SharedMutex);
+
+  // NOTE(Brajan): caches of exited threads went back to classes, blocks from there must be usable
+  TestRandom();
+}
+
+// NOTE(Brajan): thread fills ~100 spans of one class and frees everything, its cache goes back to
+// the class on exit. Only the few empty spans the class keeps may stay.
+#define NumSpanBlocks 2000
+#define SpanBlockSize 3000
+
+static void
+FillSpans(void *) {
+  static void *Blocks[NumSpanBlocks];
+  for (int Index = 0; Index < NumSpanBlocks; ++Index) {
+    Blocks[Index] = bb_AllocateMemory(SpanBlockSize);
+    Fill(Blocks[Index], SpanBlockSize);
+  }
+
+  __bb_size_class *SizeClass = &__bb_SizeClasses[__bb_GetSizeClass(SpanBlockSize)];
+  bb_Lock(&SizeClass->Mutex);
+  int NumSpans = SizeClass->NumSpans;
+  bb_Unlock(&SizeClass->Mutex);
+  Check(NumSpans >= NumSpanBlocks / (int)(__bb_MemorySpanSize / __bb_GetSizeClassSize(__bb_GetSizeClass(SpanBlockSize))), "%d spans used", NumSpans);
+
+  for (int Index = 0; Index < NumSpanBlocks; ++Index) {
+    Check(Verify(Blocks[Index], SpanBlockSize), "block %d overwritten", Index);
+    bb_FreeMemory(Blocks[Index]);
+  }
+}
+
+static void
+TestEmptySpans() {
+  __bb_size_class *SizeClass = &__bb_SizeClasses[__bb_GetSizeClass(SpanBlockSize)];
+  int NumSpans = SizeClass->NumSpans;
+  for (int Round = 0; Round < 3; ++Round) {
+    bb_thread Thread;
+    bb_CreateThread(&Thread, FillSpans, 0);
+    bb_JoinThread(&Thread);
+    bb_DestroyThread(&Thread);
+
+    Check(SizeClass->NumSpans <= NumSpans + BB_PLATFORM_MAX_EMPTY_SPANS && SizeClass->NumEmptySpans <= BB_PLATFORM_MAX_EMPTY_SPANS,
+          "round %d, %d spans left of %d before, %d empty", Round, SizeClass->NumSpans, NumSpans, SizeClass->NumEmptySpans);
+  }
+}
+
+// NOTE(Brajan): destructors of pthread keys run after the thread_local ones, so memory freed and
+// allocated there has to go to the class, not to the dead thread cache. Class of LateBlockSize is
+// used by nothing else before this test.
+#define LateBlockSize 7000
+
+#ifndef _WIN32
+static pthread_key_t LateKey;
+
+static void
+LateFree(void *Block) {
+  Check(__bb_ThreadCacheDestroyed, "key destructor before the thread cache");
+  bb_FreeMemory(Block);
+  void *Late = bb_AllocateMemory(LateBlockSize);
+  Check(Late != 0 && IsZero(Late, LateBlockSize), "allocation after the thread cache is gone");
+  Fill(Late, LateBlockSize);
+  bb_FreeMemory(Late);
+}
+
+static void
+HoldBlock(void *) {
+  void *Block = bb_AllocateMemory(LateBlockSize);
+  Fill(Block, LateBlockSize);
+  pthread_setspecific(LateKey, Block);
+}
+#endif
+
+static void
+TestLateFree() {
+#ifndef _WIN32
+  pthread_key_create(&LateKey, LateFree);
+  __bb_size_class *SizeClass = &__bb_SizeClasses[__bb_GetSizeClass(LateBlockSize)];
+  Check(SizeClass->NumSpans == 0, "%d spans before the test", SizeClass->NumSpans);
+
+  bb_thread Thread;
+  bb_CreateThread(&Thread, HoldBlock, 0);
+  bb_JoinThread(&Thread);
+  bb_DestroyThread(&Thread);
+
+  // NOTE(Brajan): every block of the class came back, so all of its spans are empty
+  Check(SizeClass->NumSpans > 0 && SizeClass->NumEmptySpans == SizeClass->NumSpans, "%d spans, %d empty", SizeClass->NumSpans, SizeClass->NumEmptySpans);
+  pthread_key_delete(LateKey);
+#endif
+}
+
+int
+main() {
+  TestSizeClasses();
+  TestLateFree();
+  TestRandom();
+  TestThreads();
+  TestEmptySpans();
+
+  printf("allocator: %d failures\n", Failures);
+  return Failures != 0;
+}
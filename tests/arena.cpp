@@ -0,0 +1,183 @@
+// tests of bb_memory_arena: pushes and alignment, remaining size, nested temporary memory, reset, and
+// per thread frame arenas that reset after bb_NextFrame and are released when their thread exits
+// build: g++ -O2 -I.. arena.cpp -o arena -lpthread
+#define BB_TOOL_IMPLEMENTATION
+#define BB_PLATFORM_IMPLEMENTATION
+#define BB_PLATFORM_NO_MAIN
+#include "bb_platform.h"
+#include "test.h"
+#ifndef _WIN32
+#include <errno.h>
+#endif
+
+struct vertex {
+  float X, Y, Z;
+};
+
+static unsigned char Memory[bb_Kilobytes(64)];
+
+static void
+TestPush() {
+  bb_memory_arena Arena;
+  bb_InitializeArena(&Arena, sizeof(Memory), Memory);
+  Check(bb_GetArenaSizeRemaining(&Arena) == sizeof(Memory), "remaining %zu", bb_GetArenaSizeRemaining(&Arena));
+
+  // NOTE(Brajan): random sizes and alignments, every block is aligned, inside the arena and after
+  // the previous one
+  unsigned char *Previous = Memory;
+  for (int Index = 0; Index < 100; ++Index) {
+    size_t Size = Random() % 300;
+    size_t Alignment = (size_t)1 << (Random() % 7);
+    size_t Remaining = bb_GetArenaSizeRemaining(&Arena, Alignment);
+    unsigned char *Block = (unsigned char *)bb_PushSize(&Arena, Size, Alignment);
+    Check(((size_t)Block & (Alignment - 1)) == 0, "%zu bytes at %p, alignment %zu", Size, (void *)Block, Alignment);
+    Check(Block >= Previous && Block + Size <= Memory + sizeof(Memory), "%zu bytes at %p", Size, (void *)Block);
+    Check(bb_GetArenaSizeRemaining(&Arena, 1) == Remaining - Size, "remaining %zu after %zu of %zu", bb_GetArenaSizeRemaining(&Arena, 1), Size, Remaining);
+    bb_ZeroMemory(Block, (unsigned int)Size);
+    Previous = Block + Size;
+  }
+
+  vertex *Vertex = bb_PushStruct(&Arena, vertex);
+  Check(((size_t)Vertex & 15) == 0, "struct at %p", (void *)Vertex);
+  float *Floats = bb_PushArrayAligned(&Arena, 7, float, 64);
+  Check(((size_t)Floats & 63) == 0 && (unsigned char *)Floats >= (unsigned char *)(Vertex + 1), "array at %p", (void *)Floats);
+
+  bb_ResetArena(&Arena);
+  Check(Arena.Used == 0 && bb_PushSize(&Arena, 1) == Memory, "reset");
+
+  // NOTE(Brajan): exact fit takes everything, remaining is 0 then
+  bb_ResetArena(&Arena);
+  bb_PushSize(&Arena, sizeof(Memory), 1);
+  Check(bb_GetArenaSizeRemaining(&Arena, 1) == 0 && bb_GetArenaSizeRemaining(&Arena, 64) == 0, "remaining %zu", bb_GetArenaSizeRemaining(&Arena, 1));
+}
+
+static void
+TestTemporaryMemory() {
+  bb_memory_arena Arena;
+  bb_InitializeArena(&Arena, sizeof(Memory), Memory);
+  bb_PushSize(&Arena, 100);
+  size_t Used = Arena.Used;
+
+  bb_temporary_memory Outer = bb_BeginTemporaryMemory(&Arena);
+  void *First = bb_PushSize(&Arena, 1000);
+  size_t OuterUsed = Arena.Used;
+
+  bb_temporary_memory Inner = bb_BeginTemporaryMemory(&Arena);
+  bb_PushArray(&Arena, 500, vertex);
+  Check(Arena.TempCount == 2, "temp count %d", Arena.TempCount);
+  bb_EndTemporaryMemory(Inner);
+  Check(Arena.Used == OuterUsed && Arena.TempCount == 1, "inner end, used %zu of %zu", Arena.Used, OuterUsed);
+
+  bb_EndTemporaryMemory(Outer);
+  Check(Arena.Used == Used && Arena.TempCount == 0, "outer end, used %zu of %zu", Arena.Used, Used);
+
+  // the same memory comes back after the roll back
+  Check(bb_PushSize(&Arena, 1000) == First, "memory after temporary memory");
+}
+
+static void
+TestFrameArena() {
+  bb_memory_arena *Arena = bb_GetFrameArena();
+  Check(Arena && Arena->Size == (size_t)BB_PLATFORM_FRAME_ARENA_SIZE, "frame arena size %zu", Arena ? Arena->Size : 0);
+
+  void *First = bb_PushSize(Arena, 1000);
+  void *Second = bb_PushSize(bb_GetFrameArena(), 1000);
+  Check(bb_GetFrameArena() == Arena && Second != First, "same frame, same arena");
+
+  // NOTE(Brajan): next frame starts from the beginning, pushes of the previous frame are gone
+  bb_NextFrame();
+  Check(bb_PushSize(bb_GetFrameArena(), 1000) == First, "reset after bb_NextFrame");
+  Check(bb_GetFrameArena()->Used == 1000, "used %zu", bb_GetFrameArena()->Used);
+}
+
+// NOTE(Brajan): every thread gets its own arena, pushes from one thread don't move the others.
+// Threads wait for each other before exiting, so no arena address is reused by a later thread.
+#define NumThreads 4
+
+static bb_memory_arena *ThreadArenas[NumThreads];
+static volatile int Broken;
+static volatile int Arrived;
+
+static void
+ThreadArena(void *Data) {
+  int Index = (int)(long long)Data;
+  bb_memory_arena *Arena = bb_GetFrameArena();
+  ThreadArenas[Index] = Arena;
+  for (int Push = 0; Push < 1000; ++Push) {
+    int *Block = bb_PushStruct(Arena, int);
+    *Block = Index;
+    if (Arena->Used > (size_t)(Push + 1) * 16)
+      bb_AtomicStore(&Broken, 1);
+    bb_Sleep(0);
+  }
+
+  bb_AtomicAdd(&Arrived, 1);
+  while (bb_AtomicLoad(&Arrived) < NumThreads)
+    bb_Sleep(1);
+}
+
+static void
+TestThreads() {
+  Broken = Arrived = 0;
+  bb_thread Threads[NumThreads];
+  for (int Index = 0; Index < NumThreads; ++Index)
+    bb_CreateThread(&Threads[Index], ThreadArena, (void *)(long long)Index);
+  for (int Index = 0; Index < NumThreads; ++Index) {
+    bb_JoinThread(&Threads[Index]);
+    bb_DestroyThread(&Threads[Index]);
+  }
+
+  bool Distinct = true;
+  for (int Index = 0; Index < NumThreads; ++Index) {
+    Distinct = Distinct && ThreadArenas[Index] != bb_GetFrameArena();
+    for (int Other = 0; Other < Index; ++Other)
+      Distinct = Distinct && ThreadArenas[Index] != ThreadArenas[Other];
+  }
+  Check(Distinct, "threads share a frame arena");
+  Check(!Broken, "frame arena used by another thread");
+}
+
+// NOTE(Brajan): asks the os whether anything is mapped at Memory, reserved only counts too
+static bool
+IsMapped(void *Memory) {
+#ifdef _WIN32
+  MEMORY_BASIC_INFORMATION Info;
+  return VirtualQuery(Memory, &Info, sizeof(Info)) != 0 && Info.State != MEM_FREE;
+#else
+  return msync(Memory, bb_GetPageSize(), MS_ASYNC) == 0 || errno != ENOMEM;
+#endif
+}
+
+static void *ExitedArenaBase;
+
+static void
+ExitingThread(void *) {
+  bb_memory_arena *Arena = bb_GetFrameArena();
+  bb_PushSize(Arena, 1000);
+  ExitedArenaBase = Arena->Base;
+}
+
+static void
+TestThreadExit() {
+  Check(IsMapped(bb_GetFrameArena()->Base), "frame arena of the main thread not mapped");
+  for (int Index = 0; Index < 4; ++Index) {
+    ExitedArenaBase = 0;
+    bb_thread Thread;
+    bb_CreateThread(&Thread, ExitingThread, 0);
+    bb_JoinThread(&Thread);
+    bb_DestroyThread(&Thread);
+    Check(ExitedArenaBase != 0 && !IsMapped(ExitedArenaBase), "thread %d, frame arena at %p not released", Index, ExitedArenaBase);
+  }
+}
+
+int
+main() {
+  TestPush();
+  TestTemporaryMemory();
+  TestFrameArena();
+  TestThreads();
+  TestThreadExit();
+
+  printf("arena: %d failures\n", Failures);
+  return Failures != 0;
+}
@@ -0,0 +1,134 @@
+// tests of frustum extraction and culling: points against a direct clip space test, batch masks of
+// bb_CullAABBs and bb_CullSpheres against bb_IsVisible with the same planes on every simd path
+// build: g++ -O2 -I.. culling.cpp -o culling
+#define BB_TOOL_IMPLEMENTATION
+#include "bb_tool.h"
+#include "test.h"
+#include <string.h>
+
+static bb_mat4
+RandomViewProjection(bool Perspective) {
+  bb_mat4 Projection = Perspective ? bb_Perspective(RandomFloat(40, 100), RandomFloat(0.5f, 2), RandomFloat(0.1f, 1), RandomFloat(50, 500))
+                                   : bb_Orthographic(-RandomFloat(5, 50), RandomFloat(5, 50), -RandomFloat(5, 50), RandomFloat(5, 50), RandomFloat(0.1f, 1), RandomFloat(50, 500));
+  bb_quaternion Rotation = bb_Normalized(bb_quaternion(RandomFloat(-1, 1), RandomFloat(-1, 1), RandomFloat(-1, 1), RandomFloat(-1, 1)));
+  bb_vec3 Position(RandomFloat(-100, 100), RandomFloat(-100, 100), RandomFloat(-100, 100));
+  return Projection * bb_AffineInverse(bb_ComposeTransform(Position, Rotation, bb_vec3(1, 1, 1)));
+}
+
+static bb_vec3
+RandomPoint() {
+  return bb_vec3(RandomFloat(-300, 300), RandomFloat(-300, 300), RandomFloat(-300, 300));
+}
+
+// NOTE(Brajan): points away from the planes have to agree with -W <= X, Y, Z <= W, the ones on the
+// border can go either way
+static void
+TestPoints() {
+  int Inside = 0, Checked = 0;
+  for (int Iteration = 0; Iteration < 200; ++Iteration) {
+    bool Perspective = Iteration & 1;
+    bb_mat4 ViewProjection = RandomViewProjection(Perspective);
+    bb_frustum Frustum = bb_ExtractFrustum(ViewProjection);
+
+    for (int Plane = 0; Plane < 6; ++Plane) {
+      float *Values = Frustum.Planes[Plane];
+      float Length = sqrtf(Values[0] * Values[0] + Values[1] * Values[1] + Values[2] * Values[2]);
+      Check(fabsf(Length - 1.0f) < 1e-5f, "plane %d normal length %f", Plane, Length);
+    }
+
+    for (int Index = 0; Index < 1000; ++Index) {
+      bb_vec3 Point = RandomPoint();
+      double In[3] = { Point.X, Point.Y, Point.Z };
+      double Clip[4];
+      for (int Row = 0; Row < 4; ++Row) {
+        Clip[Row] = ViewProjection[Row][3];
+        for (int Column = 0; Column < 3; ++Column)
+          Clip[Row] += (double)ViewProjection[Row][Column] * In[Column];
+      }
+
+      double Margin = 1e-3 * fabs(Clip[3]) + 1e-3;
+      bool Outside = false, Border = false;
+      for (int Axis = 0; Axis < 3; ++Axis) {
+        double Distance = Clip[3] - fabs(Clip[Axis]);
+        Outside = Outside || Distance < -Margin;
+        Border = Border || fabs(Distance) <= Margin;
+      }
+      if (Border && !Outside)
+        continue;
+
+      bb_sphere Sphere = { Point, 0.0f };
+      bb_aabb Box = { Point, Point };
+      Check(bb_IsVisible(Frustum, Sphere) == !Outside, "%s, point (%f %f %f)", Perspective ? "perspective" : "orthographic", Point.X, Point.Y, Point.Z);
+      Check(bb_IsVisible(Frustum, Box) == !Outside, "%s, box at (%f %f %f)", Perspective ? "perspective" : "orthographic", Point.X, Point.Y, Point.Z);
+      Inside += !Outside;
+      ++Checked;
+    }
+  }
+
+  // NOTE(Brajan): make sure the test isn't all on one side
+  Check(Inside > Checked / 100 && Inside < Checked - Checked / 100, "%d of %d points inside", Inside, Checked);
+}
+
+static bool
+MaskBit(const unsigned char *Visible, int Index) {
+  return (Visible[Index / 8] >> (Index & 7)) & 1;
+}
+
+static void
+TestBatch() {
+  static const int Counts[] = { 33, 100003 };
+  static bb_aabb Boxes[100003];
+  static bb_sphere Spheres[100003];
+  static unsigned char Visible[100003 / 8 + 2];
+
+  int Features = bb_GetCPUFeatures();
+  int Paths[2] = { Features, Features & ~bb_CPUFeatureAVX2 };
+  int NumPaths = (Features & bb_CPUFeatureAVX2) ? 2 : 1;
+  for (int Path = 0; Path < NumPaths; ++Path) {
+    __bb_CPUFeatures = Paths[Path];
+
+    for (int Round = 0; Round < 18 + (int)bb_ArrayCount(Counts); ++Round) {
+      int Count = Round < 18 ? Round : Counts[Round - 18];
+      bb_frustum Frustum = bb_ExtractFrustum(RandomViewProjection(Round & 1));
+
+      // NOTE(Brajan): sizes from points to boxes bigger than the frustum, so all cases show up
+      for (int Index = 0; Index < Count; ++Index) {
+        bb_vec3 Center = RandomPoint();
+        float Size = (Index % 4 == 0) ? RandomFloat(0, 200) : RandomFloat(0, 10);
+        bb_vec3 Extent(RandomFloat(0, Size), RandomFloat(0, Size), RandomFloat(0, Size));
+        Boxes[Index].Min = Center - Extent;
+        Boxes[Index].Max = Center + Extent;
+        Spheres[Index].Center = Center;
+        Spheres[Index].Radius = Size;
+      }
+
+      // NOTE(Brajan): mask starts all ones so bits that aren't cleared show up, byte after the mask
+      // is a guard and must stay untouched
+      int NumBytes = (Count + 7) / 8;
+      memset(Visible, 0xff, sizeof(Visible));
+      Visible[NumBytes] = 0xa5;
+      bb_CullAABBs(Frustum, Boxes, Count, Visible);
+      bool Same = Visible[NumBytes] == 0xa5;
+      for (int Index = 0; Index < Count; ++Index)
+        Same = Same && MaskBit(Visible, Index) == bb_IsVisible(Frustum, Boxes[Index]);
+      Check(Same, "path %d, %d boxes", Path, Count);
+
+      memset(Visible, 0xff, sizeof(Visible));
+      Visible[NumBytes] = 0xa5;
+      bb_CullSpheres(Frustum, Spheres, Count, Visible);
+      Same = Visible[NumBytes] == 0xa5;
+      for (int Index = 0; Index < Count; ++Index)
+        Same = Same && MaskBit(Visible, Index) == bb_IsVisible(Frustum, Spheres[Index]);
+      Check(Same, "path %d, %d spheres", Path, Count);
+    }
+  }
+}
+
+int
+main() {
+  TestPoints();
+  TestBatch();
+
+  printf("culling: %d failures\n", Failures);
+  return Failures != 0;
+}
@@ -0,0 +1,116 @@
+// tests of event handling in the main loop of bb_platform.h: the whole queue is drained every frame,
+// runs of mouse moves reach PROCESSEVENT as one event, input state and event stats per frame.
+// Uses the main of bb_platform.h, so failures are reported from SHUTDOWN.
+// build: g++ -O2 -I.. event_loop.cpp -o event_loop -lpthread
+#define BB_TOOL_IMPLEMENTATION
+#define BB_PLATFORM_IMPLEMENTATION
+#define BB_PLATFORM_LOOP Loop
+#define BB_PLATFORM_PROCESSEVENT ProcessEvent
+#define BB_PLATFORM_SHUTDOWN Shutdown
+#include "bb_platform.h"
+#include "test.h"
+#include <stdlib.h>
+
+// NOTE(Brajan): events that reached PROCESSEVENT in the current frame
+static bb_event Processed[64];
+static int NumProcessed;
+static int Frame;
+
+void
+ProcessEvent(bb_event *Event) {
+  if (NumProcessed < (int)bb_ArrayCount(Processed))
+    Processed[NumProcessed] = *Event;
+  ++NumProcessed;
+}
+
+static void
+InsertMouseMoves(int *Position, int Count) {
+  for (int Index = 0; Index < Count; ++Index) {
+    bb_event Event = {};
+    Event.Type = bb_EventMouseMove;
+    Event.Mouse.X = ++*Position;
+    Event.Mouse.Y = 2 * *Position;
+    __bb_InsertEvent(Event);
+  }
+}
+
+static void
+Insert(int Type, int Key) {
+  bb_event Event = {};
+  Event.Type = Type;
+  Event.Key = Key;
+  __bb_InsertEvent(Event);
+}
+
+static bool
+IsMouseMove(int Index, int X) {
+  return Index < NumProcessed && Processed[Index].Type == bb_EventMouseMove && Processed[Index].Mouse.X == X && Processed[Index].Mouse.Y == 2 * X;
+}
+
+// NOTE(Brajan): events inserted in a frame are handled at the start of the next one, before Loop
+void
+Loop(float) {
+  bb_platform_state *State = &bb_PlatformState;
+  static int Position = 0;
+
+  switch (Frame) {
+    case 0: {
+      Check(NumProcessed == 0 && State->EventStats.NumEvents == 0, "%d events in the first frame", NumProcessed);
+
+      // more than one batch of moves, merged across the batches
+      InsertMouseMoves(&Position, 300);
+      Insert(bb_EventKeyDown, 'A');
+      InsertMouseMoves(&Position, 10);
+      Insert(bb_EventButtonDown, bb_ButtonLeft);
+      InsertMouseMoves(&Position, 2);
+    } break;
+
+    case 1: {
+      Check(NumProcessed == 5, "%d events processed", NumProcessed);
+      Check(IsMouseMove(0, 300), "first run of moves");
+      Check(NumProcessed > 1 && Processed[1].Type == bb_EventKeyDown && Processed[1].Key == 'A', "key down");
+      Check(IsMouseMove(2, 310), "second run of moves");
+      Check(NumProcessed > 3 && Processed[3].Type == bb_EventButtonDown && Processed[3].Button == bb_ButtonLeft, "button down");
+      Check(IsMouseMove(4, 312), "last run of moves");
+
+      Check(State->EventStats.NumEvents == 314 && State->EventStats.NumMouseMoves == 312, "stats %d events, %d moves", State->EventStats.NumEvents, State->EventStats.NumMouseMoves);
+      Check(State->InputState.MouseX == 312 && State->InputState.MouseY == 624, "mouse at %d %d", State->InputState.MouseX, State->InputState.MouseY);
+      Check(State->InputState.MouseMoveX == -312 && State->InputState.MouseMoveY == -624, "mouse moved %d %d", State->InputState.MouseMoveX, State->InputState.MouseMoveY);
+      Check(State->InputState.Keys['A'] && State->InputState.KeysDown['A'], "key state");
+      Check(State->InputState.Buttons[bb_ButtonLeft] && State->InputState.ButtonsDown[bb_ButtonLeft], "button state");
+
+      // NOTE(Brajan): twice the queue size, the second half is dropped
+      for (int Index = 0; Index < 2 * BB_PLATFORM_EVENT_QUEUE_SIZE; ++Index)
+        Insert(Index & 1 ? bb_EventKeyUp : bb_EventKeyDown, 'B');
+    } break;
+
+    case 2: {
+      Check(State->EventStats.NumEvents == BB_PLATFORM_EVENT_QUEUE_SIZE && State->EventStats.NumMouseMoves == 0, "stats %d events, %d moves", State->EventStats.NumEvents, State->EventStats.NumMouseMoves);
+      Check(State->EventStats.NumDropped == BB_PLATFORM_EVENT_QUEUE_SIZE, "%lld dropped", State->EventStats.NumDropped);
+      Check(NumProcessed == BB_PLATFORM_EVENT_QUEUE_SIZE, "%d events processed", NumProcessed);
+      Check(State->InputState.MouseMoveX == 0 && State->InputState.MouseMoveY == 0, "mouse moved %d %d", State->InputState.MouseMoveX, State->InputState.MouseMoveY);
+      Check(!State->InputState.KeysDown['A'] && State->InputState.Keys['A'], "key state reset");
+
+      Insert(bb_EventQuit, 0);
+    } break;
+
+    // NOTE(Brajan): the frame that handles quit still runs Loop, then the main loop stops
+    case 3: {
+      Check(NumProcessed == 1 && Processed[0].Type == bb_EventQuit, "%d events in quit frame", NumProcessed);
+    } break;
+
+    default: {
+      Check(false, "frame %d after quit", Frame);
+    } break;
+  }
+
+  NumProcessed = 0;
+  ++Frame;
+}
+
+void
+Shutdown() {
+  Check(Frame == 4, "quit after %d frames", Frame);
+  printf("event loop: %d failures\n", Failures);
+  exit(Failures != 0);
+}
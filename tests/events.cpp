@@ -0,0 +1,131 @@
+// tests of the events queue: wrap-around of the ring with pulls of every size, dropped events when
+// it's full, and a producer thread against a consumer pulling batches
+// build: g++ -O2 -I.. events.cpp -o events -lpthread
+#define BB_TOOL_IMPLEMENTATION
+#define BB_PLATFORM_IMPLEMENTATION
+#define BB_PLATFORM_NO_MAIN
+// NOTE(Brajan): small ring so positions wrap around a lot
+#define BB_PLATFORM_EVENT_QUEUE_SIZE 16
+#include "bb_platform.h"
+#include "test.h"
+
+#define QueueSize BB_PLATFORM_EVENT_QUEUE_SIZE
+
+static void
+InsertKey(int Key) {
+  bb_event Event = {};
+  Event.Type = bb_EventKeyDown;
+  Event.Key = Key;
+  __bb_InsertEvent(Event);
+}
+
+// NOTE(Brajan): keys are a running sequence, pulled events have to continue it
+static int NextInserted = 0;
+static int NextPulled = 0;
+
+static bool
+PullInOrder(int MaxEvents, int *Count) {
+  bb_event Events[QueueSize * 2];
+  *Count = bb_PullEvents(Events, MaxEvents);
+  bool InOrder = true;
+  for (int Index = 0; Index < *Count; ++Index)
+    InOrder = InOrder && Events[Index].Type == bb_EventKeyDown && Events[Index].Key == NextPulled++;
+  return InOrder;
+}
+
+static void
+TestWrapAround() {
+  int Count;
+  Check(PullInOrder(QueueSize, &Count) && Count == 0, "empty queue gave %d events", Count);
+
+  // NOTE(Brajan): random number in, random batch out, the ring goes around many times and
+  // copies get split at its end
+  for (int Iteration = 0; Iteration < 10000; ++Iteration) {
+    int Queued = NextInserted - NextPulled;
+    int Insert = (int)(Random() % (QueueSize - Queued + 1));
+    for (int Index = 0; Index < Insert; ++Index)
+      InsertKey(NextInserted++);
+
+    Queued += Insert;
+    int MaxEvents = 1 + (int)(Random() % (QueueSize * 2 - 1));
+    int Expected = Queued < MaxEvents ? Queued : MaxEvents;
+    Check(PullInOrder(MaxEvents, &Count) && Count == Expected, "iteration %d, pulled %d of %d", Iteration, Count, Expected);
+  }
+
+  bb_event Event;
+  while (bb_PullEvent(&Event))
+    Check(Event.Key == NextPulled++, "single pull of %d", Event.Key);
+  Check(NextPulled == NextInserted && bb_GetDroppedEventCount() == 0, "%d of %d pulled, %lld dropped", NextPulled, NextInserted, bb_GetDroppedEventCount());
+
+  // NOTE(Brajan): zero and negative counts pull nothing
+  InsertKey(NextInserted++);
+  Check(PullInOrder(0, &Count) && Count == 0, "max 0 gave %d", Count);
+  Check(PullInOrder(-1, &Count) && Count == 0, "max -1 gave %d", Count);
+  Check(PullInOrder(1, &Count) && Count == 1, "max 1 gave %d", Count);
+}
+
+static void
+TestDropped() {
+  long long Dropped = bb_GetDroppedEventCount();
+  for (int Index = 0; Index < QueueSize; ++Index)
+    InsertKey(NextInserted++);
+
+  // NOTE(Brajan): full ring keeps the old events, the new ones are counted and lost
+  for (int Index = 0; Index < 5; ++Index)
+    InsertKey(-1);
+  Check(bb_GetDroppedEventCount() == Dropped + 5, "%lld dropped", bb_GetDroppedEventCount() - Dropped);
+
+  int Count;
+  Check(PullInOrder(QueueSize * 2, &Count) && Count == QueueSize, "pulled %d of full queue", Count);
+  Check(PullInOrder(QueueSize, &Count) && Count == 0, "%d events after drain", Count);
+}
+
+// NOTE(Brajan): producer inserts a sequence as fast as it can, consumer pulls random batches. Every
+// event either arrives in order or is counted as dropped.
+#define NumProducedEvents 2000000
+
+static void
+Producer(void *) {
+  for (int Index = 0; Index < NumProducedEvents; ++Index)
+    InsertKey(Index);
+}
+
+static void
+TestThreads() {
+  long long Dropped = bb_GetDroppedEventCount();
+  bb_thread Thread;
+  bb_CreateThread(&Thread, Producer, 0);
+
+  bb_event Events[QueueSize];
+  int Received = 0, Last = -1;
+  bool InOrder = true;
+  for (int Wait = 0; Wait < 100000 && Received + (int)(bb_GetDroppedEventCount() - Dropped) < NumProducedEvents;) {
+    int Count = bb_PullEvents(Events, 1 + (int)(Random() % QueueSize));
+    for (int Index = 0; Index < Count; ++Index) {
+      InOrder = InOrder && Events[Index].Key > Last;
+      Last = Events[Index].Key;
+    }
+    Received += Count;
+    if (Count == 0) {
+      bb_YieldProcessor();
+      ++Wait;
+    }
+  }
+  bb_JoinThread(&Thread);
+  bb_DestroyThread(&Thread);
+  Received += bb_PullEvents(Events, QueueSize);
+
+  long long NumDropped = bb_GetDroppedEventCount() - Dropped;
+  Check(InOrder, "events out of order");
+  Check(Received + NumDropped == NumProducedEvents, "%d received, %lld dropped", Received, NumDropped);
+}
+
+int
+main() {
+  TestWrapAround();
+  TestDropped();
+  TestThreads();
+
+  printf("events: %d failures\n", Failures);
+  return Failures != 0;
+}
@@ -0,0 +1,88 @@
+// accuracy of bb_InverseSqrt, bb_Sin, bb_Cos and bb_Tan against double precision libm, checks the
+// bounds written in bb_tool.h, and vec3 length and normalize built on top of them
+// build: g++ -O2 -DBB_MATH_FAST -I.. fast_math.cpp -o fast_math (and without BB_MATH_FAST)
+#define BB_TOOL_IMPLEMENTATION
+#include "bb_tool.h"
+#include "test.h"
+
+#ifdef BB_MATH_FAST
+#define InverseSqrtBound 5e-7
+#define SinCosBound 1e-7
+#else
+#define InverseSqrtBound 1.2e-7
+#define SinCosBound 1.2e-7
+#endif
+
+static void
+TestInverseSqrt() {
+  double MaxError = 0.0;
+  for (int Iteration = 0; Iteration < 4000000; ++Iteration) {
+    // NOTE(Brajan): random bits of a positive normal float, covers every exponent
+    unsigned int Bits = (Random() & 0x7fffffff) % 0x7f000000 + 0x00800000;
+    float Value;
+    bb_CopyMemory(&Bits, &Value, sizeof(Value));
+
+    double Expected = 1.0 / sqrt((double)Value);
+    double Error = fabs((double)bb_InverseSqrt(Value) - Expected) / Expected;
+    if (Error > MaxError)
+      MaxError = Error;
+  }
+  printf("inverse sqrt: max relative error %g\n", MaxError);
+  Check(MaxError < InverseSqrtBound, "%g", MaxError);
+}
+
+static void
+TestSinCos() {
+  double MaxSin = 0.0, MaxCos = 0.0;
+  for (int Iteration = 0; Iteration < 4000000; ++Iteration) {
+    float Range = (Iteration & 1) ? 8192.0f : 4.0f;
+    float Angle = RandomFloat(-Range, Range);
+    MaxSin = fmax(MaxSin, fabs((double)bb_Sin(Angle) - sin((double)Angle)));
+    MaxCos = fmax(MaxCos, fabs((double)bb_Cos(Angle) - cos((double)Angle)));
+  }
+  printf("sin: max absolute error %g, cos: %g\n", MaxSin, MaxCos);
+  Check(MaxSin < SinCosBound, "sin %g", MaxSin);
+  Check(MaxCos < SinCosBound, "cos %g", MaxCos);
+
+  // NOTE(Brajan): tan blows up near Pi/2, relative error away from it
+  double MaxTan = 0.0;
+  for (int Iteration = 0; Iteration < 1000000; ++Iteration) {
+    float Angle = RandomFloat(-1.5f, 1.5f);
+    double Expected = tan((double)Angle);
+    MaxTan = fmax(MaxTan, fabs((double)bb_Tan(Angle) - Expected) / fmax(fabs(Expected), 1.0));
+  }
+  printf("tan: max error %g (relative above 1)\n", MaxTan);
+  Check(MaxTan < 5e-6, "tan %g", MaxTan);
+}
+
+static void
+TestVectors() {
+  for (int Iteration = 0; Iteration < 100000; ++Iteration) {
+    float Range = (Iteration & 1) ? 1000.0f : 1.0f;
+    bb_vec3 Value(RandomFloat(-Range, Range), RandomFloat(-Range, Range), RandomFloat(-Range, Range));
+    double X = Value.X, Y = Value.Y, Z = Value.Z;
+    double Length = sqrt(X * X + Y * Y + Z * Z);
+    if (Length < 1e-3)
+      continue;
+
+    Check(fabs(bb_Length(Value) - Length) <= 1e-6 * Length, "length %f expected %f", bb_Length(Value), Length);
+
+    bb_vec3 Normalized = bb_Normalized(Value);
+    Check(fabs(Normalized.X - X / Length) < 1e-6 && fabs(Normalized.Y - Y / Length) < 1e-6 && fabs(Normalized.Z - Z / Length) < 1e-6,
+          "normalized (%f %f %f) of (%f %f %f)", Normalized.X, Normalized.Y, Normalized.Z, Value.X, Value.Y, Value.Z);
+  }
+}
+
+int
+main() {
+  TestInverseSqrt();
+  TestSinCos();
+  TestVectors();
+
+#ifdef BB_MATH_FAST
+  printf("fast math: %d failures\n", Failures);
+#else
+  printf("libm math: %d failures\n", Failures);
+#endif
+  return Failures != 0;
+}
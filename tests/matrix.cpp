@@ -0,0 +1,141 @@
+// tests of bb_mat4 multiply, batch point/direction transforms, inverses and transpose against double
+// precision math
+// build: g++ -O2 -I.. matrix.cpp -o matrix
+#define BB_TOOL_IMPLEMENTATION
+#include "bb_tool.h"
+#include "test.h"
+
+static bb_mat4
+RandomMatrix() {
+  bb_mat4 Result;
+  for (int Row = 0; Row < 4; ++Row) {
+    for (int Column = 0; Column < 4; ++Column)
+      Result[Row][Column] = RandomFloat(-10, 10);
+  }
+  return Result;
+}
+
+static bool
+Close(double Value, double Expected, double Tolerance) {
+  return fabs(Value - Expected) <= Tolerance;
+}
+
+static void
+TestMultiply() {
+  for (int Iteration = 0; Iteration < 10000; ++Iteration) {
+    bb_mat4 A = RandomMatrix();
+    bb_mat4 B = RandomMatrix();
+    bb_mat4 Result = A * B;
+
+    for (int Row = 0; Row < 4; ++Row) {
+      for (int Column = 0; Column < 4; ++Column) {
+        double Expected = 0.0;
+        for (int Index = 0; Index < 4; ++Index)
+          Expected += (double)A[Row][Index] * (double)B[Index][Column];
+        // NOTE(Brajan): four products up to 100 each, a few ulp of 400
+        Check(Close(Result[Row][Column], Expected, 1e-4), "[%d][%d] %f expected %f", Row, Column, Result[Row][Column], Expected);
+      }
+    }
+  }
+}
+
+static void
+TestTransforms() {
+  static bb_vec3 Points[1000];
+  static bb_vec3 Result[1000];
+
+  int Features = bb_GetCPUFeatures();
+  int Paths[2] = { Features, Features & ~bb_CPUFeatureAVX2 };
+  int NumPaths = (Features & bb_CPUFeatureAVX2) ? 2 : 1;
+  for (int Path = 0; Path < NumPaths; ++Path) {
+    __bb_CPUFeatures = Paths[Path];
+
+    for (int Count = 0; Count < (int)bb_ArrayCount(Points); Count += 1 + Count / 4) {
+      bb_mat4 Matrix = RandomMatrix();
+      for (int Index = 0; Index < Count; ++Index)
+        Points[Index] = bb_vec3(RandomFloat(-100, 100), RandomFloat(-100, 100), RandomFloat(-100, 100));
+
+      for (int Direction = 0; Direction < 2; ++Direction) {
+        if (Direction)
+          bb_TransformDirections(Matrix, Points, Result, Count);
+        else
+          bb_TransformPoints(Matrix, Points, Result, Count);
+
+        for (int Index = 0; Index < Count; ++Index) {
+          double In[3] = { Points[Index].X, Points[Index].Y, Points[Index].Z };
+          double Out[3] = { Result[Index].X, Result[Index].Y, Result[Index].Z };
+          for (int Row = 0; Row < 3; ++Row) {
+            double Expected = Direction ? 0.0 : Matrix[Row][3];
+            for (int Column = 0; Column < 3; ++Column)
+              Expected += (double)Matrix[Row][Column] * In[Column];
+            Check(Close(Out[Row], Expected, 1e-3), "%s %d of %d", Direction ? "direction" : "point", Index, Count);
+          }
+
+          bb_vec3 Single = Direction ? bb_TransformDirection(Matrix, Points[Index]) : bb_TransformPoint(Matrix, Points[Index]);
+          Check(Close(Single.X, Out[0], 1e-3) && Close(Single.Y, Out[1], 1e-3) && Close(Single.Z, Out[2], 1e-3),
+                "single %s %d", Direction ? "direction" : "point", Index);
+        }
+      }
+
+      // NOTE(Brajan): in place
+      if (Count) {
+        bb_vec3 Expected = bb_TransformPoint(Matrix, Points[Count - 1]);
+        bb_TransformPoints(Matrix, Points, Points, Count);
+        Check(Close(Points[Count - 1].X, Expected.X, 1e-3) && Close(Points[Count - 1].Z, Expected.Z, 1e-3), "in place, count %d", Count);
+      }
+    }
+  }
+}
+
+static bool
+CloseMatrix(const bb_mat4& A, const bb_mat4& B, double Tolerance) {
+  for (int Row = 0; Row < 4; ++Row) {
+    for (int Column = 0; Column < 4; ++Column) {
+      if (!Close(A[Row][Column], B[Row][Column], Tolerance))
+        return false;
+    }
+  }
+  return true;
+}
+
+static void
+TestInverse() {
+  for (int Iteration = 0; Iteration < 10000; ++Iteration) {
+    // NOTE(Brajan): random matrix plus big diagonal is well conditioned, so M^-1 * M is close to I
+    bb_mat4 Matrix = RandomMatrix();
+    for (int Index = 0; Index < 4; ++Index)
+      Matrix[Index][Index] += (Matrix[Index][Index] < 0.0f) ? -40.0f : 40.0f;
+    bb_mat4 Inverse = bb_Inverse(Matrix);
+    Check(CloseMatrix(Inverse * Matrix, bb_mat4(), 1e-5), "inverse * matrix, iteration %d", Iteration);
+    Check(CloseMatrix(Matrix * Inverse, bb_mat4(), 1e-5), "matrix * inverse, iteration %d", Iteration);
+
+    bb_mat4 Transposed = bb_Transpose(Matrix);
+    bool Exact = true;
+    for (int Row = 0; Row < 4; ++Row) {
+      for (int Column = 0; Column < 4; ++Column)
+        Exact = Exact && Transposed[Row][Column] == Matrix[Column][Row];
+    }
+    Check(Exact, "transpose, iteration %d", Iteration);
+
+    bb_vec3 Position(RandomFloat(-100, 100), RandomFloat(-100, 100), RandomFloat(-100, 100));
+    bb_quaternion Rotation = bb_Normalized(bb_quaternion(RandomFloat(-1, 1), RandomFloat(-1, 1), RandomFloat(-1, 1), RandomFloat(-1, 1)));
+    bb_vec3 Scale(RandomFloat(0.1f, 10), RandomFloat(0.1f, 10), RandomFloat(0.1f, 10));
+    bb_mat4 Model = bb_ComposeTransform(Position, Rotation, Scale);
+    Check(CloseMatrix(Model, bb_Translate(Position) * bb_Rotate(Rotation) * bb_Scale(Scale), 1e-4), "compose, iteration %d", Iteration);
+
+    // NOTE(Brajan): scale down to 0.1 makes inverse entries up to 10 and translation up to ~2000
+    bb_mat4 AffineInverse = bb_AffineInverse(Model);
+    Check(CloseMatrix(AffineInverse, bb_Inverse(Model), 1e-2), "affine inverse against inverse, iteration %d", Iteration);
+    Check(CloseMatrix(AffineInverse * Model, bb_mat4(), 1e-4), "affine inverse * model, iteration %d", Iteration);
+  }
+}
+
+int
+main() {
+  TestMultiply();
+  TestTransforms();
+  TestInverse();
+
+  printf("matrix: %d failures\n", Failures);
+  return Failures != 0;
+}
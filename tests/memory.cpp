@@ -0,0 +1,101 @@
+// tests of bb_ZeroMemory, bb_CopyMemory and bb_MoveMemory against libc, every simd path the cpu has
+// build: g++ -O2 -I.. memory.cpp -o memory
+#define BB_TOOL_IMPLEMENTATION
+#include "bb_tool.h"
+#include "test.h"
+#include <stdlib.h>
+#include <string.h>
+
+// NOTE(Brajan): sizes around every vector width, tails and the non temporal threshold (rarely,
+// filling 16MB takes a while)
+static unsigned int
+RandomSize() {
+  unsigned int Kind = Random() % 16;
+  if (Kind == 0)
+    return (unsigned int)BB_TOOL_NONTEMPORAL_THRESHOLD - 64 + Random() % 128;
+  if (Kind < 6)
+    return Random() % 80;
+  if (Kind < 11)
+    return Random() % 1024;
+  return Random() % (bb_Kilobytes(64));
+}
+
+static void
+Fill(unsigned char *Buffer, size_t Size) {
+  for (size_t Index = 0; Index < Size; ++Index)
+    Buffer[Index] = (unsigned char)Random();
+}
+
+static void
+TestZero(unsigned char *Buffer, unsigned char *Expected) {
+  for (int Iteration = 0; Iteration < 300; ++Iteration) {
+    size_t Size = RandomSize();
+    size_t Offset = Random() % 64;
+    size_t Touched = Offset + Size + 64;
+    Fill(Buffer, Touched);
+    memcpy(Expected, Buffer, Touched);
+
+    bb_ZeroMemory(Buffer + Offset, Size);
+    memset(Expected + Offset, 0, Size);
+    Check(memcmp(Buffer, Expected, Touched) == 0, "size %zu offset %zu", Size, Offset);
+  }
+}
+
+static void
+TestCopy(unsigned char *Source, unsigned char *Buffer, unsigned char *Expected) {
+  for (int Iteration = 0; Iteration < 300; ++Iteration) {
+    size_t Size = RandomSize();
+    size_t SourceOffset = Random() % 64;
+    size_t Offset = Random() % 64;
+    size_t Touched = Offset + Size + 64;
+    Fill(Source, SourceOffset + Size);
+    Fill(Buffer, Touched);
+    memcpy(Expected, Buffer, Touched);
+
+    bb_CopyMemory(Source + SourceOffset, Buffer + Offset, Size);
+    memcpy(Expected + Offset, Source + SourceOffset, Size);
+    Check(memcmp(Buffer, Expected, Touched) == 0, "size %zu offsets %zu %zu", Size, SourceOffset, Offset);
+  }
+}
+
+static void
+TestMove(unsigned char *Buffer, unsigned char *Expected) {
+  for (int Iteration = 0; Iteration < 300; ++Iteration) {
+    size_t Size = RandomSize();
+    size_t SourceOffset = Random() % 4096;
+    size_t Offset = Random() % 4096;
+    size_t Touched = (SourceOffset > Offset ? SourceOffset : Offset) + Size + 64;
+    Fill(Buffer, Touched);
+    memcpy(Expected, Buffer, Touched);
+
+    bb_MoveMemory(Buffer + SourceOffset, Buffer + Offset, Size);
+    memmove(Expected + Offset, Expected + SourceOffset, Size);
+    Check(memcmp(Buffer, Expected, Touched) == 0, "size %zu offsets %zu %zu", Size, SourceOffset, Offset);
+  }
+}
+
+int
+main() {
+  size_t BufferSize = BB_TOOL_NONTEMPORAL_THRESHOLD + bb_Kilobytes(16);
+  unsigned char *Source = (unsigned char *)malloc(BufferSize);
+  unsigned char *Buffer = (unsigned char *)malloc(BufferSize);
+  unsigned char *Expected = (unsigned char *)malloc(BufferSize);
+
+  // NOTE(Brajan): run once with detected features and once without AVX2, so SSE2 path is tested too
+  int Features = bb_GetCPUFeatures();
+  int Paths[2] = { Features, Features & ~bb_CPUFeatureAVX2 };
+  int NumPaths = (Features & bb_CPUFeatureAVX2) ? 2 : 1;
+  for (int Path = 0; Path < NumPaths; ++Path) {
+    __bb_CPUFeatures = Paths[Path];
+    TestZero(Buffer, Expected);
+    TestCopy(Source, Buffer, Expected);
+    TestMove(Buffer, Expected);
+  }
+
+  free(Source);
+  free(Buffer);
+  free(Expected);
+
+  printf("memory: %d paths, %d failures\n", NumPaths, Failures);
+  return Failures != 0;
+}
@@ -0,0 +1,108 @@
+// tests of bb_mutex and bb_rw_mutex with 1 to 8 threads doing a random mix of locks, try locks,
+// reads and writes
+// build: g++ -O2 -I.. mutex.cpp -o mutex -lpthread
+#define BB_TOOL_IMPLEMENTATION
+#define BB_PLATFORM_IMPLEMENTATION
+#define BB_PLATFORM_NO_MAIN
+#include "bb_platform.h"
+#include "test.h"
+
+#define NumIterations 100000
+
+static bb_mutex Mutex;
+static bb_rw_mutex RWMutex;
+
+// NOTE(Brajan): plain (not atomic) counters, only correct when the lock works
+static long long Counter;
+static long long First;
+static long long Second;
+
+static volatile int NumWriters;
+static volatile int NumReaders;
+static volatile int NumLocks;
+static volatile int NumReads;
+static volatile int NumWrites;
+static volatile int Broken;
+
+static void
+Worker(void *Data) {
+  // NOTE(Brajan): random state per thread, seeded with thread index
+  unsigned int State = 2654435761u * (unsigned int)((long long)Data + 1);
+
+  for (int Iteration = 0; Iteration < NumIterations; ++Iteration) {
+    unsigned int Value = Random(&State);
+    switch (Value % 8) {
+    case 0:
+      if (bb_TryLock(&Mutex)) {
+        ++Counter;
+        bb_AtomicAdd(&NumLocks, 1);
+        bb_Unlock(&Mutex);
+      }
+      break;
+    case 1:
+    case 2:
+    case 3:
+      bb_Lock(&Mutex);
+      ++Counter;
+      bb_AtomicAdd(&NumLocks, 1);
+      bb_Unlock(&Mutex);
+      break;
+    case 4:
+      bb_LockWrite(&RWMutex);
+      if (bb_AtomicAdd(&NumWriters, 1) != 0 || bb_AtomicLoad(&NumReaders) != 0)
+        bb_AtomicStore(&Broken, 1);
+      ++First;
+      if (Value & 256)
+        bb_YieldProcessor();
+      ++Second;
+      bb_AtomicAdd(&NumWrites, 1);
+      bb_AtomicAdd(&NumWriters, -1);
+      bb_UnlockWrite(&RWMutex);
+      break;
+    default:
+      bb_LockRead(&RWMutex);
+      bb_AtomicAdd(&NumReaders, 1);
+      if (bb_AtomicLoad(&NumWriters) != 0 || First != Second)
+        bb_AtomicStore(&Broken, 1);
+      bb_AtomicAdd(&NumReads, 1);
+      bb_AtomicAdd(&NumReaders, -1);
+      bb_UnlockRead(&RWMutex);
+      break;
+    }
+  }
+}
+
+int
+main() {
+  bb_CreateMutex(&Mutex);
+  bb_CreateRWMutex(&RWMutex);
+
+  for (int NumThreads = 1; NumThreads <= 8; NumThreads *= 2) {
+    Counter = First = Second = 0;
+    NumLocks = NumReads = NumWrites = Broken = 0;
+
+    bb_thread Threads[8];
+    for (int Index = 0; Index < NumThreads; ++Index)
+      bb_CreateThread(&Threads[Index], Worker, (void *)(long long)Index);
+    for (int Index = 0; Index < NumThreads; ++Index) {
+      bb_JoinThread(&Threads[Index]);
+      bb_DestroyThread(&Threads[Index]);
+    }
+
+    Check(Counter == NumLocks, "%d threads, counter %lld, %d locks", NumThreads, Counter, NumLocks);
+    Check(First == NumWrites && Second == NumWrites, "%d threads, %lld %lld, %d writes", NumThreads, First, Second, NumWrites);
+    Check(NumLocks + NumReads + NumWrites > NumThreads * NumIterations / 2, "%d threads, too few operations", NumThreads);
+    Check(!Broken, "%d threads, writer was not alone", NumThreads);
+
+    // NOTE(Brajan): everything has to be unlocked at the end
+    Check(bb_TryLock(&Mutex), "%d threads, mutex left locked", NumThreads);
+    bb_Unlock(&Mutex);
+    Check(RWMutex.State == 0, "%d threads, rw state %x", NumThreads, RWMutex.State);
+  }
+
+  bb_DestroyRWMutex(&RWMutex);
+  bb_DestroyMutex(&Mutex);
+
+  printf("mutex: %d failures\n", Failures);
+  return Failures != 0;
+}
@@ -0,0 +1,137 @@
+// tests of the batch quaternion kernels against scalar math, and accuracy of bb_SlerpN against
+// double precision slerp, weights within 2e-5 give up to 3e-5 in the blended output
+// build: g++ -O2 -I.. quaternion.cpp -o quaternion
+#define BB_TOOL_IMPLEMENTATION
+#include "bb_tool.h"
+#include "test.h"
+#include <stdlib.h>
+
+static bb_quaternion
+RandomRotation() {
+  bb_quaternion Result(RandomFloat(-1, 1), RandomFloat(-1, 1), RandomFloat(-1, 1), RandomFloat(-1, 1));
+  return bb_Normalized(Result);
+}
+
+static float
+Difference(bb_quaternion A, bb_quaternion B) {
+  float Result = fabsf(A.X - B.X);
+  Result = fmaxf(Result, fabsf(A.Y - B.Y));
+  Result = fmaxf(Result, fabsf(A.Z - B.Z));
+  return fmaxf(Result, fabsf(A.W - B.W));
+}
+
+static float
+Difference(bb_vec3 A, bb_vec3 B) {
+  return fmaxf(fabsf(A.X - B.X), fmaxf(fabsf(A.Y - B.Y), fabsf(A.Z - B.Z)));
+}
+
+// NOTE(Brajan): exact slerp in double, shorter way
+static bb_quaternion
+SlerpExact(bb_quaternion A, bb_quaternion B, double T) {
+  double Dot = (double)A.X * B.X + (double)A.Y * B.Y + (double)A.Z * B.Z + (double)A.W * B.W;
+  double Sign = 1.0;
+  if (Dot < 0.0) {
+    Dot = -Dot;
+    Sign = -1.0;
+  }
+  if (Dot > 1.0)
+    Dot = 1.0;
+
+  double Angle = acos(Dot);
+  double WeightA = 1.0 - T, WeightB = T;
+  if (Angle > 1e-9) {
+    WeightA = sin((1.0 - T) * Angle) / sin(Angle);
+    WeightB = sin(T * Angle) / sin(Angle);
+  }
+  WeightB *= Sign;
+  return bb_quaternion((float)(A.X * WeightA + B.X * WeightB), (float)(A.Y * WeightA + B.Y * WeightB),
+                       (float)(A.Z * WeightA + B.Z * WeightB), (float)(A.W * WeightA + B.W * WeightB));
+}
+
+static void
+TestKernels(bb_memory_arena *Arena, int Count, float *MaxSlerpError) {
+  bb_temporary_memory Temporary = bb_BeginTemporaryMemory(Arena);
+  bb_quaternion_soa A = bb_PushQuaternionSoA(Arena, Count);
+  bb_quaternion_soa B = bb_PushQuaternionSoA(Arena, Count);
+  bb_quaternion_soa Result = bb_PushQuaternionSoA(Arena, Count);
+  bb_vec3_soa Vectors = bb_PushVec3SoA(Arena, Count);
+  bb_vec3_soa Rotated = bb_PushVec3SoA(Arena, Count);
+
+  for (int Index = 0; Index < Count; ++Index) {
+    bb_quaternion QA = RandomRotation();
+    bb_quaternion QB = RandomRotation();
+    // NOTE(Brajan): every fourth pair is close together, where slerp weights are hardest
+    if (Index % 4 == 0)
+      QB = bb_Normalized(bb_quaternion(QA.X + RandomFloat(-0.01f, 0.01f), QA.Y, QA.Z, -QA.W));
+    bb_SetQuaternion(A, Index, QA);
+    bb_SetQuaternion(B, Index, QB);
+    bb_SetVec3(Vectors, Index, bb_vec3(RandomFloat(-10, 10), RandomFloat(-10, 10), RandomFloat(-10, 10)));
+  }
+
+  bb_quaternion Rotation = RandomRotation();
+  bb_RotateN(Rotation, Vectors, Rotated, Count);
+  for (int Index = 0; Index < Count; ++Index) {
+    bb_vec3 Expected = bb_Rotate(bb_GetVec3(Vectors, Index), Rotation);
+    Check(Difference(bb_GetVec3(Rotated, Index), Expected) < 1e-4f, "rotate by one %d of %d", Index, Count);
+  }
+
+  bb_RotateN(A, Vectors, Rotated, Count);
+  for (int Index = 0; Index < Count; ++Index) {
+    bb_vec3 Expected = bb_Rotate(bb_GetVec3(Vectors, Index), bb_GetQuaternion(A, Index));
+    Check(Difference(bb_GetVec3(Rotated, Index), Expected) < 1e-4f, "rotate %d of %d", Index, Count);
+  }
+
+  // NOTE(Brajan): scaled copies have to come back as the unit ones
+  for (int Index = 0; Index < Count; ++Index) {
+    bb_quaternion Value = bb_GetQuaternion(A, Index);
+    float Scale = RandomFloat(0.1f, 10.0f);
+    bb_SetQuaternion(Result, Index, bb_quaternion(Value.X * Scale, Value.Y * Scale, Value.Z * Scale, Value.W * Scale));
+  }
+  bb_NormalizeN(Result, Result, Count);
+  for (int Index = 0; Index < Count; ++Index)
+    Check(Difference(bb_GetQuaternion(Result, Index), bb_GetQuaternion(A, Index)) < 1e-6f, "normalize %d of %d", Index, Count);
+
+  float T = RandomFloat(0, 1);
+  bb_NlerpN(A, B, T, Result, Count);
+  for (int Index = 0; Index < Count; ++Index) {
+    bb_quaternion Expected = bb_Nlerp(bb_GetQuaternion(A, Index), bb_GetQuaternion(B, Index), T);
+    Check(Difference(bb_GetQuaternion(Result, Index), Expected) < 1e-6f, "nlerp %d of %d", Index, Count);
+  }
+
+  for (int Step = 0; Step <= 8; ++Step) {
+    T = (float)Step / 8.0f;
+    bb_SlerpN(A, B, T, Result, Count);
+    for (int Index = 0; Index < Count; ++Index) {
+      bb_quaternion Value = bb_GetQuaternion(Result, Index);
+      float Error = Difference(Value, SlerpExact(bb_GetQuaternion(A, Index), bb_GetQuaternion(B, Index), T));
+      *MaxSlerpError = fmaxf(*MaxSlerpError, Error);
+      Check(Error <= 3e-5f, "slerp %d of %d, T %f, error %g", Index, Count, T, Error);
+    }
+  }
+
+  bb_EndTemporaryMemory(Temporary);
+}
+
+int
+main() {
+  size_t ArenaSize = bb_Megabytes(8);
+  bb_memory_arena Arena;
+  bb_InitializeArena(&Arena, ArenaSize, malloc(ArenaSize));
+
+  float MaxSlerpError = 0.0f;
+  int Features = bb_GetCPUFeatures();
+  int Paths[2] = { Features, Features & ~bb_CPUFeatureAVX2 };
+  int NumPaths = (Features & bb_CPUFeatureAVX2) ? 2 : 1;
+  for (int Path = 0; Path < NumPaths; ++Path) {
+    __bb_CPUFeatures = Paths[Path];
+    for (int Count = 0; Count <= 20; ++Count)
+      TestKernels(&Arena, Count, &MaxSlerpError);
+    for (int Iteration = 0; Iteration < 20; ++Iteration)
+      TestKernels(&Arena, 10000, &MaxSlerpError);
+  }
+
+  free(Arena.Base);
+
+  printf("quaternion: %d paths, max slerp error %g, %d failures\n", NumPaths, MaxSlerpError, Failures);
+  return Failures != 0;
+}
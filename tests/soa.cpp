@@ -0,0 +1,89 @@
+// tests of the SoA batch kernels (bb_DotN, bb_CrossN, bb_NormalizeN, bb_AddScaledN) against scalar
+// math, for counts that leave tails on every path
+// build: g++ -O2 -I.. soa.cpp -o soa (and with -DBB_MATH_FAST)
+#define BB_TOOL_IMPLEMENTATION
+#include "bb_tool.h"
+#include "test.h"
+#include <stdlib.h>
+
+// NOTE(Brajan): error relative to the size of the inputs, not of the result (cancellation)
+static bool
+Close(float Value, float Expected, float Scale, float Tolerance) {
+  return fabsf(Value - Expected) <= Tolerance * (Scale > 1.0f ? Scale : 1.0f);
+}
+
+static bool
+Close(bb_vec3 Value, bb_vec3 Expected, float Scale, float Tolerance) {
+  return Close(Value.X, Expected.X, Scale, Tolerance) && Close(Value.Y, Expected.Y, Scale, Tolerance) &&
+         Close(Value.Z, Expected.Z, Scale, Tolerance);
+}
+
+static void
+TestKernels(bb_memory_arena *Arena, int Count) {
+  bb_temporary_memory Temporary = bb_BeginTemporaryMemory(Arena);
+  bb_vec3_soa A = bb_PushVec3SoA(Arena, Count);
+  bb_vec3_soa B = bb_PushVec3SoA(Arena, Count);
+  bb_vec3_soa Result = bb_PushVec3SoA(Arena, Count);
+  float *Dots = bb_PushArray(Arena, Count, float);
+
+  for (int Index = 0; Index < Count; ++Index) {
+    float Range = (Index % 3 == 0) ? 1000.0f : 1.0f;
+    bb_SetVec3(A, Index, bb_vec3(RandomFloat(-Range, Range), RandomFloat(-Range, Range), RandomFloat(-Range, Range)));
+    bb_SetVec3(B, Index, bb_vec3(RandomFloat(-1, 1), RandomFloat(-1, 1), RandomFloat(-1, 1)));
+  }
+
+  bb_DotN(A, B, Dots, Count);
+  for (int Index = 0; Index < Count; ++Index) {
+    bb_vec3 VA = bb_GetVec3(A, Index), VB = bb_GetVec3(B, Index);
+    float Scale = bb_Length(VA) * bb_Length(VB);
+    Check(Close(Dots[Index], bb_Dot(VA, VB), Scale, 1e-6f), "dot %d of %d", Index, Count);
+  }
+
+  bb_CrossN(A, B, Result, Count);
+  for (int Index = 0; Index < Count; ++Index) {
+    bb_vec3 VA = bb_GetVec3(A, Index), VB = bb_GetVec3(B, Index);
+    float Scale = bb_Length(VA) * bb_Length(VB);
+    Check(Close(bb_GetVec3(Result, Index), bb_Cross(VA, VB), Scale, 1e-6f), "cross %d of %d", Index, Count);
+  }
+
+  bb_NormalizeN(A, Result, Count);
+  for (int Index = 0; Index < Count; ++Index) {
+    bb_vec3 Expected = bb_Normalized(bb_GetVec3(A, Index));
+    Check(Close(bb_GetVec3(Result, Index), Expected, 1.0f, 1e-6f), "normalize %d of %d", Index, Count);
+  }
+
+  // NOTE(Brajan): in place, Result is A
+  float Scale = RandomFloat(-4, 4);
+  bb_vec3 *Expected = bb_PushArray(Arena, Count, bb_vec3);
+  for (int Index = 0; Index < Count; ++Index)
+    Expected[Index] = bb_GetVec3(A, Index) + bb_GetVec3(B, Index) * Scale;
+  bb_AddScaledN(A, B, Scale, A, Count);
+  for (int Index = 0; Index < Count; ++Index) {
+    float Size = bb_Length(Expected[Index]) + 4.0f;
+    Check(Close(bb_GetVec3(A, Index), Expected[Index], Size, 1e-6f), "add scaled %d of %d", Index, Count);
+  }
+
+  bb_EndTemporaryMemory(Temporary);
+}
+
+int
+main() {
+  size_t ArenaSize = bb_Megabytes(4);
+  bb_memory_arena Arena;
+  bb_InitializeArena(&Arena, ArenaSize, malloc(ArenaSize));
+
+  int Features = bb_GetCPUFeatures();
+  int Paths[2] = { Features, Features & ~bb_CPUFeatureAVX2 };
+  int NumPaths = (Features & bb_CPUFeatureAVX2) ? 2 : 1;
+  for (int Path = 0; Path < NumPaths; ++Path) {
+    __bb_CPUFeatures = Paths[Path];
+    for (int Count = 0; Count <= 40; ++Count)
+      TestKernels(&Arena, Count);
+    TestKernels(&Arena, 10007);
+  }
+
+  free(Arena.Base);
+
+  printf("soa: %d paths, %d failures\n", NumPaths, Failures);
+  return Failures != 0;
+}
@@ -0,0 +1,119 @@
+// tests of the string functions against libc, strings also end right before an unmapped page to
+// catch vector loads that read too far
+// build: g++ -O2 -I.. string.cpp -o string -lpthread
+#define BB_TOOL_IMPLEMENTATION
+#define BB_PLATFORM_IMPLEMENTATION
+#define BB_PLATFORM_NO_MAIN
+#include "bb_platform.h"
+#include "test.h"
+#include <string.h>
+
+static int
+Sign(int Value) {
+  return (Value > 0) - (Value < 0);
+}
+
+// NOTE(Brajan): small alphabet so compared strings share long prefixes, high bytes check that
+// comparison is unsigned like in libc
+static void
+RandomString(char *String, int Length) {
+  static const char Alphabet[] = { 'a', 'b', 'c', (char)0xe9 };
+  for (int Index = 0; Index < Length; ++Index)
+    String[Index] = Alphabet[Random() % 4];
+  String[Length] = 0;
+}
+
+static int
+RandomLength() {
+  return (Random() % 4 == 0) ? (int)(Random() % 600) : (int)(Random() % 70);
+}
+
+static void
+TestStrings(char *A, char *B) {
+  int LengthA = (int)strlen(A);
+  Check(bb_StringLength(A) == LengthA, "length %d", LengthA);
+  Check(Sign(bb_StringCompare(A, B)) == Sign(strcmp(A, B)), "lengths %d %d", LengthA, (int)strlen(B));
+
+  unsigned int Length = Random() % 700;
+  Check(Sign(bb_StringCompareLength(A, B, Length)) == Sign(strncmp(A, B, Length)), "compare length %u", Length);
+
+  char Character = (Random() % 8) ? A[Random() % (LengthA + 1)] : 'x';
+  Check(bb_StringFindChar(A, Character) == strchr(A, Character), "find %d in length %d", Character, LengthA);
+
+  if (strcmp(A, B) == 0)
+    Check(bb_StringHash(A) == bb_StringHash(B), "hash of equal strings, length %d", LengthA);
+}
+
+static void
+TestHash() {
+  // NOTE(Brajan): bytes after the terminator don't count, every length hashes differently
+  char A[128], B[128];
+  int Collisions = 0;
+  unsigned long long Previous = 0;
+  for (int Length = 0; Length < 100; ++Length) {
+    RandomString(A, Length);
+    memcpy(B, A, Length + 1);
+    B[Length + 1] = 'q';
+    A[Length + 1] = 'r';
+    Check(bb_StringHash(A) == bb_StringHash(B), "length %d", Length);
+
+    B[Length / 2] ^= 1;
+    if (Length && bb_StringHash(A) == bb_StringHash(B))
+      ++Collisions;
+
+    A[Length] = 0;
+    unsigned long long Hash = bb_StringHash(A);
+    if (Length && Hash == Previous)
+      ++Collisions;
+    Previous = Hash;
+  }
+  Check(Collisions == 0, "%d collisions", Collisions);
+}
+
+int
+main() {
+  static char A[1024], B[1024];
+
+  // NOTE(Brajan): second page is reserved only, touching it crashes
+  size_t PageSize = bb_GetPageSize();
+  char *Page = (char *)bb_ReserveMemory(PageSize * 2, bb_MemoryDefault);
+  bb_CommitMemory(Page, PageSize);
+  char *PageEnd = Page + PageSize;
+
+  int Features = bb_GetCPUFeatures();
+  int Paths[2] = { Features, Features & ~bb_CPUFeatureAVX2 };
+  int NumPaths = (Features & bb_CPUFeatureAVX2) ? 2 : 1;
+  for (int Path = 0; Path < NumPaths; ++Path) {
+    __bb_CPUFeatures = Paths[Path];
+
+    for (int Iteration = 0; Iteration < 20000; ++Iteration) {
+      int LengthA = RandomLength();
+      int LengthB = RandomLength();
+      char *StringA = A + Random() % 64;
+      char *StringB = B + Random() % 64;
+      RandomString(StringA, LengthA);
+      if (Random() % 2) {
+        // NOTE(Brajan): same prefix, differs somewhere (or not at all)
+        memcpy(StringB, StringA, LengthA + 1);
+        if (LengthA && Random() % 4)
+          StringB[Random() % LengthA] ^= 1;
+      } else {
+        RandomString(StringB, LengthB);
+      }
+      TestStrings(StringA, StringB);
+
+      // NOTE(Brajan): the same string moved to the end of the page
+      int Length = (int)strlen(StringA);
+      char *AtPageEnd = PageEnd - Length - 1;
+      memcpy(AtPageEnd, StringA, Length + 1);
+      TestStrings(AtPageEnd, StringB);
+      TestStrings(StringB, AtPageEnd);
+    }
+    TestHash();
+  }
+
+  bb_ReleaseMemory(Page, PageSize * 2);
+
+  printf("string: %d paths, %d failures\n", NumPaths, Failures);
+  return Failures != 0;
+}
@@ -0,0 +1,304 @@
+// tests of bb_task_group and bb_ParallelFor with 1 to 8 workers: nested pushes from inside tasks,
+// waiting thread running queued tasks itself, parked waiter woken by nested pushes, many threads
+// waiting on one group, grain edge cases and ranges ending at INT_MAX
+// build: g++ -O2 -I.. task_group.cpp -o task_group -lpthread
+#define BB_TOOL_IMPLEMENTATION
+#define BB_PLATFORM_IMPLEMENTATION
+#define BB_PLATFORM_NO_MAIN
+#include "bb_platform.h"
+#include "test.h"
+#include <limits.h>
+
+static bb_thread_pool Pool;
+static bb_task_group Group;
+static volatile int Count;
+
+static void
+CountTask(void *) {
+  bb_AtomicAdd(&Count, 1);
+}
+
+// NOTE(Brajan): every task pushes 4 children with Depth - 1 into the same group
+static void
+TreeTask(void *Data) {
+  long long Depth = (long long)Data;
+  bb_AtomicAdd(&Count, 1);
+  if (Depth > 0) {
+    for (int Index = 0; Index < 4; ++Index)
+      bb_PushTaskToGroup(&Pool, &Group, TreeTask, (void *)(Depth - 1));
+  }
+}
+
+static int
+TreeSize(int Depth) {
+  return Depth == 0 ? 1 : 1 + 4 * TreeSize(Depth - 1);
+}
+
+static void
+TestGroups(int NumWorkers) {
+  for (int Round = 0; Round < 20; ++Round) {
+    int NumTasks = (int)(Random() % 10000);
+    Count = 0;
+    bb_InitTaskGroup(&Group);
+    for (int Index = 0; Index < NumTasks; ++Index)
+      Check(bb_PushTaskToGroup(&Pool, &Group, CountTask, 0) == 0, "push %d", Index);
+    bb_WaitTaskGroup(&Pool, &Group);
+    Check(Count == NumTasks, "%d workers, %d of %d tasks", NumWorkers, Count, NumTasks);
+  }
+
+  // NOTE(Brajan): waiting on a group with nothing in it returns right away
+  bb_InitTaskGroup(&Group);
+  bb_WaitTaskGroup(&Pool, &Group);
+
+  for (int Depth = 0; Depth <= 6; ++Depth) {
+    Count = 0;
+    bb_InitTaskGroup(&Group);
+    bb_PushTaskToGroup(&Pool, &Group, TreeTask, (void *)(long long)Depth);
+    bb_WaitTaskGroup(&Pool, &Group);
+    Check(Count == TreeSize(Depth), "%d workers, depth %d, %d of %d tasks", NumWorkers, Depth, Count, TreeSize(Depth));
+  }
+}
+
+// parallel for
+static volatile int Visits[100000];
+static volatile int NumCalls;
+static volatile int BadRanges;
+static int ForGrain;
+
+static void
+VisitRange(int Begin, int End, void *) {
+  int Grain = ForGrain < 1 ? 1 : ForGrain;
+  if (Begin >= End || End - Begin > Grain)
+    bb_AtomicAdd(&BadRanges, 1);
+  for (int Index = Begin; Index < End; ++Index)
+    bb_AtomicAdd(&Visits[Index], 1);
+  bb_AtomicAdd(&NumCalls, 1);
+}
+
+static bool
+ParallelForVisits(int Begin, int End, int Grain, int *Calls) {
+  for (int Index = 0; Index < (int)bb_ArrayCount(Visits); ++Index)
+    Visits[Index] = 0;
+  NumCalls = 0;
+  BadRanges = 0;
+  ForGrain = Grain;
+
+  bb_ParallelFor(&Pool, Begin, End, Grain, VisitRange, 0);
+
+  bool Once = BadRanges == 0;
+  for (int Index = 0; Index < (int)bb_ArrayCount(Visits); ++Index)
+    Once = Once && Visits[Index] == (Index >= Begin && Index < End ? 1 : 0);
+  *Calls = NumCalls;
+  return Once;
+}
+
+static void
+TestParallelFor(int NumWorkers) {
+  int Calls;
+  for (int Round = 0; Round < 50; ++Round) {
+    int Begin = (int)(Random() % 1000);
+    int End = Begin + (int)(Random() % (bb_ArrayCount(Visits) - Begin));
+    int Grain = 1 + (int)(Random() % 300);
+    Check(ParallelForVisits(Begin, End, Grain, &Calls), "%d workers, [%d, %d) grain %d", NumWorkers, Begin, End, Grain);
+    Check(Calls == (End - Begin + Grain - 1) / Grain, "%d workers, %d calls for [%d, %d) grain %d", NumWorkers, Calls, Begin, End, Grain);
+  }
+
+  // NOTE(Brajan): grain bigger than the range is one call with the whole range
+  Check(ParallelForVisits(10, 20, 1000, &Calls) && Calls == 1, "%d workers, grain over range, %d calls", NumWorkers, Calls);
+
+  // grain of 0 or less is treated as 1
+  Check(ParallelForVisits(0, 100, 0, &Calls) && Calls == 100, "%d workers, grain 0, %d calls", NumWorkers, Calls);
+  Check(ParallelForVisits(0, 100, -5, &Calls) && Calls == 100, "%d workers, grain -5, %d calls", NumWorkers, Calls);
+
+  // empty and reversed ranges don't call the function
+  Check(ParallelForVisits(50, 50, 10, &Calls) && Calls == 0, "%d workers, begin == end, %d calls", NumWorkers, Calls);
+  Check(ParallelForVisits(60, 50, 10, &Calls) && Calls == 0, "%d workers, begin > end, %d calls", NumWorkers, Calls);
+}
+
+// NOTE(Brajan): range ending at INT_MAX, workers taking chunks past the end must not wrap around
+// into negative Begin
+static volatile long long NumItems;
+
+static void
+CountRange(int Begin, int End, void *) {
+  if (Begin < INT_MAX - 1000 || Begin >= End)
+    bb_AtomicAdd(&BadRanges, 1);
+  bb_AtomicAdd64(&NumItems, (long long)End - Begin);
+}
+
+static void
+TestParallelForLimit(int NumWorkers) {
+  for (int Grain = 1; Grain <= 1000; Grain *= 10) {
+    NumItems = 0;
+    BadRanges = 0;
+    bb_ParallelFor(&Pool, INT_MAX - 1000, INT_MAX, Grain, CountRange, 0);
+    Check(NumItems == 1000 && BadRanges == 0, "%d workers, grain %d, %lld items, %d bad ranges", NumWorkers, Grain, (long long)NumItems, BadRanges);
+  }
+}
+
+// NOTE(Brajan): parallel for from inside group tasks, workers wait on their own groups while the
+// outer group is still pending
+static volatile long long NestedSum;
+
+static void
+SumRange(int Begin, int End, void *) {
+  long long Sum = 0;
+  for (int Index = Begin; Index < End; ++Index)
+    Sum += Index;
+  bb_AtomicAdd64(&NestedSum, Sum);
+}
+
+static void
+NestedForTask(void *) {
+  bb_ParallelFor(&Pool, 0, 1000, 7, SumRange, 0);
+}
+
+static void
+TestNestedParallelFor(int NumWorkers) {
+  NestedSum = 0;
+  bb_InitTaskGroup(&Group);
+  for (int Index = 0; Index < 16; ++Index)
+    bb_PushTaskToGroup(&Pool, &Group, NestedForTask, 0);
+  bb_WaitTaskGroup(&Pool, &Group);
+  Check(NestedSum == 16 * 499500LL, "%d workers, nested parallel for sum %lld", NumWorkers, (long long)NestedSum);
+}
+
+// NOTE(Brajan): several threads outside of the pool and the main thread wait on one group, all of
+// them have to come back once and only after every task ran
+#define NumWaiters 8
+
+static volatile int NumReturned;
+static volatile int ReturnedEarly;
+static int NumGroupTasks;
+
+static void
+SlowTask(void *) {
+  bb_Sleep(1);
+  bb_AtomicAdd(&Count, 1);
+}
+
+static void
+Waiter(void *) {
+  bb_WaitTaskGroup(&Pool, &Group);
+  if (bb_AtomicLoad(&Count) != NumGroupTasks)
+    bb_AtomicStore(&ReturnedEarly, 1);
+  bb_AtomicAdd(&NumReturned, 1);
+}
+
+static void
+TestManyWaiters(int NumWorkers) {
+  Count = 0;
+  NumReturned = 0;
+  ReturnedEarly = 0;
+  NumGroupTasks = 200;
+  bb_InitTaskGroup(&Group);
+  for (int Index = 0; Index < NumGroupTasks; ++Index)
+    bb_PushTaskToGroup(&Pool, &Group, SlowTask, 0);
+
+  bb_thread Threads[NumWaiters];
+  for (int Index = 0; Index < NumWaiters; ++Index)
+    bb_CreateThread(&Threads[Index], Waiter, 0);
+  Waiter(0);
+  for (int Index = 0; Index < NumWaiters; ++Index) {
+    bb_JoinThread(&Threads[Index]);
+    bb_DestroyThread(&Threads[Index]);
+  }
+
+  Check(NumReturned == NumWaiters + 1 && !ReturnedEarly, "%d workers, %d waiters returned, early %d", NumWorkers, NumReturned, ReturnedEarly);
+}
+
+// NOTE(Brajan): the only worker is stuck in a task outside of the group, so the waiting thread has
+// to run all tasks of the group itself. The gate opens after the wait returns, or after ~5s so a
+// broken wait fails instead of hanging.
+static volatile int GateStarted;
+static volatile int GateOpen;
+static volatile int WaitReturned;
+
+static void
+GateTask(void *) {
+  bb_AtomicStore(&GateStarted, 1);
+  while (!bb_AtomicLoad(&GateOpen))
+    bb_Sleep(1);
+}
+
+static void
+OpenGate(void *) {
+  for (int Wait = 0; Wait < 5000 && !bb_AtomicLoad(&WaitReturned); ++Wait)
+    bb_Sleep(1);
+  bb_AtomicStore(&GateOpen, 1);
+}
+
+static void
+TestWaiterHelps() {
+  bb_CreateThreadPool(&Pool, 1, 4096);
+  GateStarted = GateOpen = WaitReturned = 0;
+  bb_PushTaskToThreadPool(&Pool, GateTask, 0);
+  while (!bb_AtomicLoad(&GateStarted))
+    bb_Sleep(1);
+
+  bb_thread Thread;
+  bb_CreateThread(&Thread, OpenGate, 0);
+
+  Count = 0;
+  bb_InitTaskGroup(&Group);
+  for (int Index = 0; Index < 1000; ++Index)
+    bb_PushTaskToGroup(&Pool, &Group, CountTask, 0);
+  bb_WaitTaskGroup(&Pool, &Group);
+  bool GateWasOpen = bb_AtomicLoad(&GateOpen) != 0;
+  bb_AtomicStore(&WaitReturned, 1);
+
+  bb_JoinThread(&Thread);
+  bb_DestroyThread(&Thread);
+  bb_DestroyThreadPool(&Pool);
+
+  Check(Count == 1000 && !GateWasOpen, "waiter ran %d of 1000 tasks, gate open %d", Count, GateWasOpen);
+}
+
+// NOTE(Brajan): the only worker runs a group task that pushes more tasks to the group only after the
+// waiter parked, then blocks until they ran. Nobody but the waiter can run them, so the push has to
+// wake it. Gives up after ~5s instead of hanging.
+static volatile int SpawnerTimedOut;
+
+static void
+SpawnerTask(void *) {
+  bb_Sleep(50);
+  for (int Index = 0; Index < 1000; ++Index)
+    bb_PushTaskToGroup(&Pool, &Group, CountTask, 0);
+
+  int Wait = 0;
+  for (; Wait < 5000 && bb_AtomicLoad(&Count) < 1000; ++Wait)
+    bb_Sleep(1);
+  if (Wait == 5000)
+    bb_AtomicStore(&SpawnerTimedOut, 1);
+}
+
+static void
+TestParkedWaiter() {
+  bb_CreateThreadPool(&Pool, 1, 4096);
+  Count = 0;
+  SpawnerTimedOut = 0;
+  bb_InitTaskGroup(&Group);
+  bb_PushTaskToGroup(&Pool, &Group, SpawnerTask, 0);
+  bb_WaitTaskGroup(&Pool, &Group);
+  bb_DestroyThreadPool(&Pool);
+
+  Check(Count == 1000 && !SpawnerTimedOut, "parked waiter ran %d of 1000 nested tasks", Count);
+}
+
+int
+main() {
+  for (int NumWorkers = 1; NumWorkers <= 8; NumWorkers *= 2) {
+    bb_CreateThreadPool(&Pool, NumWorkers, 16384);
+    TestGroups(NumWorkers);
+    TestParallelFor(NumWorkers);
+    TestParallelForLimit(NumWorkers);
+    TestNestedParallelFor(NumWorkers);
+    TestManyWaiters(NumWorkers);
+    bb_DestroyThreadPool(&Pool);
+  }
+  TestWaiterHelps();
+  TestParkedWaiter();
+
+  printf("task group: %d failures\n", Failures);
+  return Failures != 0;
+}
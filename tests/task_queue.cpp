@@ -0,0 +1,137 @@
+// tests of the shared bb_thread_pool task queue: many producer threads outside of the pool against
+// 1 to 4 workers, fifo order, and push failing when the queue is full
+// build: g++ -O2 -I.. task_queue.cpp -o task_queue -lpthread
+#define BB_TOOL_IMPLEMENTATION
+#define BB_PLATFORM_IMPLEMENTATION
+#define BB_PLATFORM_NO_MAIN
+#include "bb_platform.h"
+#include "test.h"
+
+#define MaxProducers 8
+#define TasksPerProducer 10000
+
+static bb_thread_pool Pool;
+static volatile int Count;
+static volatile int Seen[MaxProducers][TasksPerProducer];
+static volatile int LastSeen[MaxProducers];
+static volatile int OutOfOrder;
+
+// NOTE(Brajan): Data is producer index in high bits and sequence number in low bits
+static void
+RecordTask(void *Data) {
+  long long Value = (long long)Data;
+  int Producer = (int)(Value >> 32);
+  int Sequence = (int)(Value & 0xffffffff);
+  bb_AtomicAdd(&Seen[Producer][Sequence], 1);
+
+  // only meaningful with one worker, that one pops the queue in order
+  if (Sequence <= LastSeen[Producer])
+    bb_AtomicStore(&OutOfOrder, 1);
+  LastSeen[Producer] = Sequence;
+
+  bb_AtomicAdd(&Count, 1);
+}
+
+static void
+Producer(void *Data) {
+  long long Index = (long long)Data;
+  for (long long Sequence = 0; Sequence < TasksPerProducer; ++Sequence) {
+    // NOTE(Brajan): queue is bounded, retry while it's full
+    while (bb_PushTaskToThreadPool(&Pool, RecordTask, (void *)((Index << 32) | Sequence)) != 0)
+      bb_YieldProcessor();
+  }
+}
+
+// NOTE(Brajan): gives up after ~10s instead of hanging when tasks get lost
+static bool
+WaitForCount(int Expected) {
+  for (int Wait = 0; Wait < 10000 && bb_AtomicLoad(&Count) < Expected; ++Wait)
+    bb_Sleep(1);
+  return bb_AtomicLoad(&Count) == Expected;
+}
+
+static void
+TestProducers(int NumWorkers, int NumProducers) {
+  bb_ZeroMemory((void *)Seen, sizeof(Seen));
+  for (int Index = 0; Index < MaxProducers; ++Index)
+    LastSeen[Index] = -1;
+  OutOfOrder = 0;
+  Count = 0;
+
+  bb_CreateThreadPool(&Pool, NumWorkers, 4096);
+  bb_thread Threads[MaxProducers];
+  for (int Index = 0; Index < NumProducers; ++Index)
+    bb_CreateThread(&Threads[Index], Producer, (void *)(long long)Index);
+  for (int Index = 0; Index < NumProducers; ++Index) {
+    bb_JoinThread(&Threads[Index]);
+    bb_DestroyThread(&Threads[Index]);
+  }
+  // NOTE(Brajan): destroy drops what is still queued, wait for all of it to run first
+  WaitForCount(NumProducers * TasksPerProducer);
+  bb_DestroyThreadPool(&Pool);
+
+  bool Once = true;
+  for (int Index = 0; Index < NumProducers; ++Index) {
+    for (int Sequence = 0; Sequence < TasksPerProducer; ++Sequence)
+      Once = Once && Seen[Index][Sequence] == 1;
+  }
+  Check(Once && Count == NumProducers * TasksPerProducer, "%d workers, %d producers, %d tasks ran", NumWorkers, NumProducers, Count);
+  if (NumWorkers == 1)
+    Check(!OutOfOrder, "%d producers, tasks of one producer ran out of order", NumProducers);
+}
+
+static volatile int Started;
+static volatile int Released;
+static int Order[64];
+static int NumOrdered;
+
+static void
+GateTask(void *) {
+  bb_AtomicStore(&Started, 1);
+  while (!bb_AtomicLoad(&Released))
+    bb_YieldProcessor();
+}
+
+static void
+OrderTask(void *Data) {
+  Order[NumOrdered++] = (int)(long long)Data;
+  bb_AtomicAdd(&Count, 1);
+}
+
+static void
+TestFull() {
+  // NOTE(Brajan): 50 rounds up to 64 cells
+  bb_CreateThreadPool(&Pool, 1, 50);
+  Started = Released = 0;
+  NumOrdered = 0;
+  Count = 0;
+
+  bb_PushTaskToThreadPool(&Pool, GateTask, 0);
+  while (!bb_AtomicLoad(&Started))
+    bb_YieldProcessor();
+
+  for (long long Index = 0; Index < 64; ++Index)
+    Check(bb_PushTaskToThreadPool(&Pool, OrderTask, (void *)Index) == 0, "push %lld", Index);
+  Check(bb_PushTaskToThreadPool(&Pool, OrderTask, 0) != 0, "push to full queue");
+
+  bb_AtomicStore(&Released, 1);
+  WaitForCount(64);
+  bb_DestroyThreadPool(&Pool);
+
+  bool InOrder = NumOrdered == 64;
+  for (int Index = 0; Index < NumOrdered; ++Index)
+    InOrder = InOrder && Order[Index] == Index;
+  Check(InOrder, "%d tasks, fifo order", NumOrdered);
+}
+
+int
+main() {
+  for (int NumWorkers = 1; NumWorkers <= 4; NumWorkers *= 2) {
+    for (int NumProducers = 1; NumProducers <= MaxProducers; NumProducers *= 2)
+      TestProducers(NumWorkers, NumProducers);
+  }
+  TestFull();
+
+  printf("task queue: %d failures\n", Failures);
+  return Failures != 0;
+}
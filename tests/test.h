@@ -0,0 +1,36 @@
+// shared by the tests, include after bb_tool.h (or bb_platform.h): failure counter, Check and xorshift
+// random numbers. Every test prints its failures and returns non zero from main when there are any.
+#include <stdio.h>
+
+static int Failures = 0;
+
+// NOTE(Brajan): prints only the first 10 failures, the rest are just counted
+#define Check(Condition, ...)                                       \
+  do {                                                              \
+    if (!(Condition) && ++Failures <= 10) {                         \
+      printf("%s:%d: %s failed: ", __FILE__, __LINE__, #Condition); \
+      printf(__VA_ARGS__);                                          \
+      printf("\n");                                                 \
+    }                                                               \
+  } while (0)
+
+static unsigned int RandomState = 0x9e3779b9;
+
+// xorshift, threads pass their own State
+inline unsigned int
+Random(unsigned int *State) {
+  *State ^= *State << 13;
+  *State ^= *State >> 17;
+  *State ^= *State << 5;
+  return *State;
+}
+
+inline unsigned int
+Random() {
+  return Random(&RandomState);
+}
+
+inline float
+RandomFloat(float Min, float Max) {
+  return Min + (Max - Min) * (float)(Random() >> 8) / (float)(1 << 24);
+}
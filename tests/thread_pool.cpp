@@ -0,0 +1,155 @@
+// tests of bb_thread_pool with 1 to 8 workers: tasks pushed from the main thread and tasks pushed
+// from inside other tasks (own deque, stealing) all run exactly once, destroy runs what is still
+// queued, and create fails cleanly on bad arguments and when memory runs out
+// build: g++ -O2 -I.. thread_pool.cpp -o thread_pool -lpthread
+#define BB_TOOL_IMPLEMENTATION
+#define BB_PLATFORM_IMPLEMENTATION
+#define BB_PLATFORM_NO_MAIN
+#include "bb_platform.h"
+#include "test.h"
+#include <limits.h>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+static bb_thread_pool Pool;
+static volatile int Count;
+static volatile int Visits[10000];
+
+static void
+VisitTask(void *Data) {
+  bb_AtomicAdd(&Visits[(long long)Data], 1);
+  bb_AtomicAdd(&Count, 1);
+}
+
+// NOTE(Brajan): every task pushes 4 children with Depth - 1, they land in the worker's own deque
+// and other workers have to steal them
+static void
+TreeTask(void *Data) {
+  long long Depth = (long long)Data;
+  if (Depth > 0) {
+    for (int Index = 0; Index < 4; ++Index)
+      bb_PushTaskToThreadPool(&Pool, TreeTask, (void *)(Depth - 1));
+  }
+  bb_AtomicAdd(&Count, 1);
+}
+
+static int
+TreeSize(int Depth) {
+  return Depth == 0 ? 1 : 1 + 4 * TreeSize(Depth - 1);
+}
+
+// NOTE(Brajan): gives up after ~10s instead of hanging when tasks get lost
+static bool
+WaitForCount(int Expected) {
+  for (int Wait = 0; Wait < 10000 && bb_AtomicLoad(&Count) < Expected; ++Wait)
+    bb_Sleep(1);
+  return bb_AtomicLoad(&Count) == Expected;
+}
+
+static void
+TestExternal(int NumWorkers) {
+  for (int Round = 0; Round < 20; ++Round) {
+    int NumTasks = (int)(Random() % bb_ArrayCount(Visits));
+    for (int Index = 0; Index < NumTasks; ++Index)
+      Visits[Index] = 0;
+    Count = 0;
+
+    for (long long Index = 0; Index < NumTasks; ++Index)
+      Check(bb_PushTaskToThreadPool(&Pool, VisitTask, (void *)Index) == 0, "push %lld", Index);
+    Check(WaitForCount(NumTasks), "%d workers, %d of %d tasks", NumWorkers, Count, NumTasks);
+
+    bool Once = true;
+    for (int Index = 0; Index < NumTasks; ++Index)
+      Once = Once && Visits[Index] == 1;
+    Check(Once, "%d workers, task ran twice or not at all", NumWorkers);
+  }
+}
+
+static void
+TestNested(int NumWorkers) {
+  for (int Depth = 0; Depth <= 6; ++Depth) {
+    Count = 0;
+    bb_PushTaskToThreadPool(&Pool, TreeTask, (void *)(long long)Depth);
+    Check(WaitForCount(TreeSize(Depth)), "%d workers, depth %d, %d of %d tasks", NumWorkers, Depth, Count, TreeSize(Depth));
+  }
+}
+
+// NOTE(Brajan): destroy right after pushing, tasks still in the queues have to run before the
+// workers exit
+static void
+TestDestroyRunsQueued(int NumWorkers) {
+  for (int Round = 0; Round < 20; ++Round) {
+    bb_CreateThreadPool(&Pool, NumWorkers, 16384);
+    Count = 0;
+    int NumTasks = 1000 + (int)(Random() % 9000);
+    for (long long Index = 0; Index < NumTasks; ++Index)
+      bb_PushTaskToThreadPool(&Pool, VisitTask, (void *)Index);
+    bb_PushTaskToThreadPool(&Pool, TreeTask, (void *)4LL);
+    bb_DestroyThreadPool(&Pool);
+    Check(Count == NumTasks + TreeSize(4), "%d workers, %d of %d tasks before destroy", NumWorkers, Count, NumTasks + TreeSize(4));
+  }
+}
+
+static void
+TestCreateFailures() {
+  static const int Arguments[][2] = { { 0, 16 }, { -1, 16 }, { 4, 0 }, { 4, -5 }, { 4, INT_MAX }, { INT_MAX, 16 } };
+  for (int Index = 0; Index < (int)bb_ArrayCount(Arguments); ++Index) {
+    int Result = bb_CreateThreadPool(&Pool, Arguments[Index][0], Arguments[Index][1]);
+    Check(Result != 0 && Pool.Workers == 0 && Pool.Tasks == 0 && Pool.Deques == 0 && Pool.NumWorkers == 0,
+          "%d workers, %d tasks, result %d", Arguments[Index][0], Arguments[Index][1], Result);
+    bb_DestroyThreadPool(&Pool);
+  }
+
+#ifndef _WIN32
+  // NOTE(Brajan): limit address space to 300MB more than used now. Queue of 2^22 tasks is 128MB and
+  // every deque 96MB, so 4 workers fail on the second deque. The same pool with 1 worker fits only
+  // when the failed one gave everything back.
+  FILE *File = fopen("/proc/self/statm", "r");
+  unsigned long long Pages = 0;
+  if (File) {
+    if (fscanf(File, "%llu", &Pages) != 1)
+      Pages = 0;
+    fclose(File);
+  }
+  if (Pages == 0)
+    return;
+
+  struct rlimit Limit;
+  getrlimit(RLIMIT_AS, &Limit);
+  struct rlimit Lower = Limit;
+  Lower.rlim_cur = (rlim_t)(Pages * bb_GetPageSize() + 300ULL * 1024 * 1024);
+  if (Limit.rlim_cur != RLIM_INFINITY && Limit.rlim_cur < Lower.rlim_cur)
+    return;
+  setrlimit(RLIMIT_AS, &Lower);
+
+  int Result = bb_CreateThreadPool(&Pool, 4, 1 << 22);
+  Check(Result != 0 && Pool.Workers == 0 && Pool.Tasks == 0 && Pool.Deques == 0, "out of memory, result %d", Result);
+  Result = bb_CreateThreadPool(&Pool, 1, 1 << 22);
+  Check(Result == 0, "pool after out of memory, result %d", Result);
+  if (Result == 0) {
+    Count = 0;
+    bb_PushTaskToThreadPool(&Pool, VisitTask, 0);
+    Check(WaitForCount(1), "pool after out of memory ran %d tasks", Count);
+    bb_DestroyThreadPool(&Pool);
+  }
+
+  setrlimit(RLIMIT_AS, &Limit);
+#endif
+}
+
+int
+main() {
+  for (int NumWorkers = 1; NumWorkers <= 8; NumWorkers *= 2) {
+    bb_CreateThreadPool(&Pool, NumWorkers, 16384);
+    TestExternal(NumWorkers);
+    TestNested(NumWorkers);
+    bb_DestroyThreadPool(&Pool);
+    TestDestroyRunsQueued(NumWorkers);
+  }
+
+  TestCreateFailures();
+
+  printf("thread pool: %d failures\n", Failures);
+  return Failures != 0;
+}
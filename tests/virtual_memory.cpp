@@ -0,0 +1,139 @@
+// tests of reserve/commit/decommit virtual memory with normal and large pages, and virtual arenas
+// committing more memory as they grow past the first commit
+// build: g++ -O2 -I.. virtual_memory.cpp -o virtual_memory -lpthread
+#define BB_TOOL_IMPLEMENTATION
+#define BB_PLATFORM_IMPLEMENTATION
+#define BB_PLATFORM_NO_MAIN
+#include "bb_platform.h"
+#include "test.h"
+
+static bool
+IsFilled(unsigned char *Memory, size_t Size, unsigned char Value) {
+  for (size_t Index = 0; Index < Size; ++Index) {
+    if (Memory[Index] != Value)
+      return false;
+  }
+  return true;
+}
+
+static void
+TestPageSizes() {
+  size_t PageSize = bb_GetPageSize();
+  size_t LargePageSize = bb_GetLargePageSize();
+  Check(PageSize >= 4096 && (PageSize & (PageSize - 1)) == 0, "page size %zu", PageSize);
+  Check(LargePageSize >= PageSize && LargePageSize % PageSize == 0, "large page size %zu", LargePageSize);
+}
+
+// NOTE(Brajan): memory comes zeroed after commit, and zeroed again after decommit and commit
+static void
+TestReserveCommit(int Flags) {
+  size_t PageSize = (Flags & bb_MemoryLargePages) ? bb_GetLargePageSize() : bb_GetPageSize();
+  size_t Size = 8 * PageSize;
+  unsigned char *Memory = (unsigned char *)bb_ReserveMemory(Size, Flags);
+  Check(Memory != 0, "flags %d, reserve %zu", Flags, Size);
+  if (!Memory)
+    return;
+#ifndef _WIN32
+  // NOTE(Brajan): windows without SeLockMemoryPrivilege gives normal reservation, 64KB aligned only
+  Check(((size_t)Memory & (PageSize - 1)) == 0, "flags %d, %p not aligned to %zu", Flags, (void *)Memory, PageSize);
+#endif
+
+  Check(bb_CommitMemory(Memory, 2 * PageSize), "flags %d, commit first pages", Flags);
+  Check(IsFilled(Memory, 2 * PageSize, 0), "flags %d, committed memory not zeroed", Flags);
+  for (size_t Index = 0; Index < 2 * PageSize; ++Index)
+    Memory[Index] = 0xab;
+
+  // commit more in the middle, first pages keep their content
+  Check(bb_CommitMemory(Memory + 4 * PageSize, 4 * PageSize), "flags %d, commit last pages", Flags);
+  for (size_t Index = 4 * PageSize; Index < 8 * PageSize; ++Index)
+    Memory[Index] = 0xcd;
+  Check(IsFilled(Memory, 2 * PageSize, 0xab), "flags %d, first pages lost after commit", Flags);
+
+  // NOTE(Brajan): large pages on windows are committed whole and can't be decommitted, skip that there
+#ifdef _WIN32
+  if (!(Flags & bb_MemoryLargePages))
+#endif
+  {
+    bb_DecommitMemory(Memory + 4 * PageSize, 2 * PageSize);
+    Check(bb_CommitMemory(Memory + 4 * PageSize, 2 * PageSize), "flags %d, commit after decommit", Flags);
+    Check(IsFilled(Memory + 4 * PageSize, 2 * PageSize, 0), "flags %d, decommitted pages not zeroed", Flags);
+    Check(IsFilled(Memory + 6 * PageSize, 2 * PageSize, 0xcd), "flags %d, pages after decommit lost", Flags);
+    Check(IsFilled(Memory, 2 * PageSize, 0xab), "flags %d, pages before decommit lost", Flags);
+  }
+
+  bb_ReleaseMemory(Memory, Size);
+}
+
+// NOTE(Brajan): counts commits of the arena, otherwise same as bb_CommitMemory
+static int NumCommits;
+
+static bool
+CountCommit(void *Memory, size_t Size) {
+  ++NumCommits;
+  return bb_CommitMemory(Memory, Size);
+}
+
+static void
+TestVirtualArena(int Flags, size_t CommitGranularity) {
+  bb_memory_arena Arena;
+  bb_CreateVirtualArena(&Arena, bb_Megabytes(64), Flags, CommitGranularity);
+  Arena.Commit = CountCommit;
+  NumCommits = 0;
+
+  size_t Granularity = Arena.CommitGranularity;
+  size_t PageSize = (Flags & bb_MemoryLargePages) ? bb_GetLargePageSize() : bb_GetPageSize();
+  Check(Arena.Size == (size_t)bb_Megabytes(64) && Arena.CommittedSize == 0, "flags %d, size %zu, committed %zu", Flags, Arena.Size, Arena.CommittedSize);
+  Check(Granularity >= PageSize && Granularity % PageSize == 0, "flags %d, granularity %zu", Flags, Granularity);
+  if (CommitGranularity == 0 && !(Flags & bb_MemoryLargePages))
+    Check(Granularity == 64 * 1024, "flags %d, default granularity %zu", Flags, Granularity);
+
+  // NOTE(Brajan): push well past the first commit, every byte is writable and commits stay one
+  // granule ahead at most
+  size_t Total = 3 * Granularity + Granularity / 2;
+  unsigned char *Previous = 0;
+  for (size_t Pushed = 0; Pushed < Total; Pushed += 1000) {
+    unsigned char *Block = (unsigned char *)bb_PushSize(&Arena, 1000, 1);
+    Check(Previous == 0 || Block == Previous + 1000, "flags %d, base moved", Flags);
+    Check(IsFilled(Block, 1000, 0), "flags %d, %zu not zeroed", Flags, Pushed);
+    for (int Index = 0; Index < 1000; ++Index)
+      Block[Index] = (unsigned char)Pushed;
+    Check(Arena.CommittedSize >= Arena.Used && Arena.CommittedSize < Arena.Used + Granularity && Arena.CommittedSize % Granularity == 0,
+          "flags %d, committed %zu for %zu used", Flags, Arena.CommittedSize, Arena.Used);
+    Previous = Block;
+  }
+  Check(NumCommits == (int)((Arena.Used + Granularity - 1) / Granularity), "flags %d, %d commits for %zu used", Flags, NumCommits, Arena.Used);
+
+  // NOTE(Brajan): reset keeps committed memory, pushing again doesn't commit
+  int Commits = NumCommits;
+  bb_ResetArena(&Arena);
+  bb_PushSize(&Arena, Total);
+  Check(NumCommits == Commits, "flags %d, commit after reset", Flags);
+
+  bb_DestroyVirtualArena(&Arena);
+  Check(Arena.Base == 0 && Arena.Size == 0 && Arena.CommittedSize == 0, "flags %d, destroyed arena", Flags);
+}
+
+static void
+TestFrameArena() {
+  bb_memory_arena *Arena = bb_GetFrameArena();
+  Check(Arena->Commit != 0 && Arena->Size == (size_t)BB_PLATFORM_FRAME_ARENA_SIZE, "frame arena size %zu", Arena->Size);
+
+  // NOTE(Brajan): only the used part gets committed
+  unsigned char *Memory = (unsigned char *)bb_PushSize(Arena, bb_Megabytes(1));
+  Memory[bb_Megabytes(1) - 1] = 1;
+  Check(Arena->CommittedSize >= Arena->Used && Arena->CommittedSize < Arena->Size, "frame arena committed %zu", Arena->CommittedSize);
+}
+
+int
+main() {
+  TestPageSizes();
+  TestReserveCommit(bb_MemoryDefault);
+  TestReserveCommit(bb_MemoryLargePages);
+  TestVirtualArena(bb_MemoryDefault, 0);
+  TestVirtualArena(bb_MemoryDefault, 10000);
+  TestVirtualArena(bb_MemoryLargePages, 0);
+  TestFrameArena();
+
+  printf("virtual memory: %d failures\n", Failures);
+  return Failures != 0;
+}